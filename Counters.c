@@ -0,0 +1,47 @@
+/*
+	Counters
+	
+	Event counters, for the host to read
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+ 	References:
+		[HID] Device Class Definition for Human Interface Devices (HID) Version 1.11
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Counters.h"
+#include "Timer1.h"
+#include "USBEndpoint1.h"
+
+
+/*	gCounters
+	Incremented where the events happen
+*/
+Counters gCounters;
+
+
+/*	GetCountersReport
+	Put the counters in a Feature report [HID §7.2.1]
+*/
+void GetCountersReport(
+	uint8_t		*buffer
+	)
+{
+buffer[0] = kReportIDCounters;
+
+/* Some of the counters are updated by the interrupt handler; keep it out so
+   that we don't copy half of an update.  PIC18 is little-endian, like USB. */
+const bool interrupts = INTCONbits.GIE;
+INTCONbits.GIE = 0;
+
+const uint8_t *from = (const uint8_t*) &gCounters;
+for (uint8_t i = 1; i < kCountersReportLength; i++)
+	buffer[i] = *from++;
+
+INTCONbits.GIE = interrupts;
+}
@@ -0,0 +1,39 @@
+/*
+	Counters
+	
+	Event counters, for the host to read
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#pragma once
+
+
+/*	Counters
+	Counts since start-up of what would otherwise go unnoticed in the field
+	
+	The counts wrap around at 65536; the host is expected to read them
+	periodically and take the differences.
+*/
+typedef struct {
+	uint16_t	reportsReceived;		// Output reports received (Endpoint 1 OUT or SetReport)
+	uint16_t	reportsSent;			// Input reports collected by the host on Endpoint 1 IN
+	uint16_t	reportsWaited;			// reports held back because the SIE owned both IN buffer descriptors
+	uint16_t	keysMerged;			// key presses merged into a waiting report (queue full)
+	uint16_t	spiWaited;			// SPI exchanges queued behind another one
+	uint16_t	usbErrors;			// USB errors (UERRIF)
+	uint16_t	errors;				// calls of Error()
+	uint16_t	interruptCycles;		// longest time in the high priority interrupt handler, in instruction cycles (only with PROFILE; otherwise 0)
+	} Counters;
+
+
+/*	kCountersReportLength
+	Report ID, and the counters (little-endian)
+*/
+enum { kCountersReportLength = 1 + sizeof (Counters) };
+
+
+extern Counters gCounters;
+
+extern void GetCountersReport(uint8_t *);
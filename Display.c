@@ -25,10 +25,18 @@
 		https://www.analog.com/en/resources/design-notes/extending-max6954-and-max6955-keyscan-beyond-32-keys.html
 */
 
+#include <stdbool.h>
+
 #include <xc.h>
 
 #include "Display.h"
+#include "Profile.h"
 #include "SPI.h"
+#include "Switches.h"
+#include "Task.h"
+#include "Timer.h"
+#include "Timer1.h"
+#include "Trace.h"
 #include "USBEndpoint1.h"
 
 
@@ -64,6 +72,52 @@ union XX {
 	};
 
 
+/*	gDigits
+	Shadow copy of the MAX6954 plane 0 digit registers, in the order
+	0 through 5 (value 0) and 0a through 5a (value 1); with a bit set in
+	gDigitsDirty for each digit that the MAX doesn't have yet
+*/
+enum { kDigitsN = 12 };
+
+static const char gDigitRegisters[kDigitsN] = {
+	kRegisterDigit0Plane0 + 0, kRegisterDigit0Plane0 + 1, kRegisterDigit0Plane0 + 2,
+	kRegisterDigit0Plane0 + 3, kRegisterDigit0Plane0 + 4, kRegisterDigit0Plane0 + 5,
+	kRegisterDigit0APlane0 + 0, kRegisterDigit0APlane0 + 1, kRegisterDigit0APlane0 + 2,
+	kRegisterDigit0APlane0 + 3, kRegisterDigit0APlane0 + 4, kRegisterDigit0APlane0 + 5
+	};
+
+static char gDigits[kDigitsN];
+static uint16_t gDigitsDirty = (1 << kDigitsN) - 1;
+
+
+/*	gIntensity
+	Shadow copy of the MAX6954 global intensity register; and whether the MAX
+	doesn't have it yet
+*/
+static uint8_t gIntensity;
+static bool gIntensityDirty;
+
+
+/*	gKeys
+	The keys that were down at the last scan; bit 8 * n + k is key k of key
+	line n (P0 through P3, i.e., the MAX Key A through Key D registers)
+*/
+static uint32_t gKeys;
+
+
+/*	kKeysPollPeriod
+	ms between scans while any key is down
+	
+	The MAX only interrupts when a key is pressed, not when it is released; so
+	as long as keys are down, we look again periodically to learn when they
+	come up.  Without this, a key that was released and pressed again between
+	two interrupts would look like it had been held down all along.
+*/
+enum { kKeysPollPeriod = 20 };
+
+static Timer gKeysPollTimer;
+
+
 /*	DisplayInitialize
 	
 */
@@ -86,14 +140,20 @@ static char buffer[] = {
 	/* Trying to use compound literal here, but don't know how to convert that back to the integral type*/
 	kRegisterConfiguration, 0x01,
 	
-	// port configuration (8 keys scanned; P1,2,3 are left as output; P4 becomes IRQ)
-	kRegisterPortConfiguration, 0x20,
+	// port configuration (32 keys scanned; P0,1,2,3 are key inputs; P4 becomes IRQ)
+	kRegisterPortConfiguration, 0x80,
 	
-	// key mask (enable interrupt on 0)
-	kRegisterKeyAMaskDebounce + 0, 1 << 0,
+	// key masks (enable interrupt on all keys)
+	kRegisterKeyAMaskDebounce + 0, 0xFF,
+	kRegisterKeyAMaskDebounce + 1, 0xFF,
+	kRegisterKeyAMaskDebounce + 2, 0xFF,
+	kRegisterKeyAMaskDebounce + 3, 0xFF,
 	
-	// read Key A Debounce register to reset IRQ
+	// read Key A Debounce registers to reset IRQ
 	0x80 | (kRegisterKeyAMaskDebounce + 0), 0,
+	0x80 | (kRegisterKeyAMaskDebounce + 1), 0,
+	0x80 | (kRegisterKeyAMaskDebounce + 2), 0,
+	0x80 | (kRegisterKeyAMaskDebounce + 3), 0,
 	
 	// test pattern
 	#if 0
@@ -117,6 +177,15 @@ static char buffer[] = {
 // transfer MAX 6954 configuration
 SPIStartExchange(buffer, sizeof buffer, NULL);
 
+// we don't know what the MAX is displaying; next update has to send all digits
+gDigitsDirty = (1 << kDigitsN) - 1;
+
+// the configuration above reset the intensity
+gIntensityDirty = gIntensity != 0;
+
+// no keys down
+gKeys = 0;
+
 /* Only enable this after we've intialized the MAX so that we know it will be
    able to process and responsive to SPI. */
 
@@ -132,6 +201,7 @@ TRISBbits.RB2 = 1;			// input
 WPUBbits.WPUB2 = 1;			// enable pull-up
 
 // enable INT2 external interrupt
+INTCON3bits.INT2IP = 0;			// low priority
 INTCON3bits.INT2IE = 1;
 }
 
@@ -144,6 +214,9 @@ void DisplayTerminate()
 // disable INT2 external interrupt
 INTCON3bits.INT2IE = 0;
 
+// stop polling the keys
+TimerStop(&gKeysPollTimer);
+
 // clear condition flag (just in case)
 INTCON3bits.INT2IF = 0;
 
@@ -153,8 +226,11 @@ static char buffer[] = {
 	/* Trying to use compound literal here, but don't know how to convert that back to the integral type*/
 	kRegisterConfiguration, 0x00,
 	
-	// key mask (disable interrupts)
-	kRegisterKeyAMaskDebounce + 0, 0
+	// key masks (disable interrupts)
+	kRegisterKeyAMaskDebounce + 0, 0,
+	kRegisterKeyAMaskDebounce + 1, 0,
+	kRegisterKeyAMaskDebounce + 2, 0,
+	kRegisterKeyAMaskDebounce + 3, 0
 	};
 
 // transfer MAX 6954 configuration
@@ -166,68 +242,352 @@ SPIStartExchange(buffer, sizeof buffer, NULL);
 __uint24 gValue0, gValue1;
 
 
+/*	gDigitsState
+	Whether a frame of digit commands is waiting for its Start-of-Frame (see
+	DISPLAY_SYNC_FRAMES), or on (or queued for) the SPI bus
+	
+	One byte, so that main() and the Start-of-Frame handler see the change
+	from waiting to sending at once.
+*/
+enum { kDigitsIdle, kDigitsWaiting, kDigitsSending };
+
+static volatile uint8_t gDigitsState;
+
+
+/*	gDigitsFrame
+	The frame of digit commands waiting or in flight; and while it waits,
+	which digits (and whether the intensity) it has
+*/
+static char gDigitsFrame[2 * kDigitsN + 2];
+static uint8_t gDigitsFrameL;
+static uint16_t gDigitsFrameDigits;
+static bool gDigitsFrameIntensity;
+
+
+static void DisplayDigitsSent(void);
+
+
+/*	DisplayDigits
+	Send the digits (and intensity) that changed to the MAX6954
+	
+	There is at most one frame of digit commands in flight.  Updates that
+	arrive in the meantime only go into the shadow copy, where a newer value
+	replaces an older one that was never sent; the next frame is built from
+	the shadow copy when the one in flight completes.  So the frame on the bus
+	is never modified, and the display lags the latest values by at most one
+	frame however fast they arrive.
+	
+	A frame that is only waiting for its Start-of-Frame is not on the bus
+	yet: it is built again, with the latest values.
+	
+	Only called from main-line code.
+*/
+static void DisplayDigits()
+{
+char *const buffer = gDigitsFrame;
+uint8_t bufferL = 0;
+
+// take back a frame waiting for its Start-of-Frame
+/* Keep the Start-of-Frame handler from committing it meanwhile */
+INTCONbits.GIEH = 0;
+const uint8_t state = gDigitsState;
+if (state == kDigitsWaiting) gDigitsState = kDigitsIdle;
+INTCONbits.GIEH = 1;
+
+// already have a frame on the bus?
+if (state == kDigitsSending) return;
+
+// what the waiting frame had goes in the new one
+if (state == kDigitsWaiting) {
+	gDigitsDirty |= gDigitsFrameDigits;
+	gIntensityDirty |= gDigitsFrameIntensity;
+	}
+
+// build a command for each dirty digit
+/* Walk a mask rather than shifting by the digit index: the PIC18 has no
+   barrel shifter. */
+uint16_t mask = 1;
+for (uint8_t d = 0; d < kDigitsN; d++, mask <<= 1)
+	if (gDigitsDirty & mask) {
+		buffer[bufferL++] = gDigitRegisters[d];
+		buffer[bufferL++] = gDigits[d];
+		}
+
+gDigitsFrameDigits = gDigitsDirty;
+gDigitsDirty = 0;
+
+gDigitsFrameIntensity = gIntensityDirty;
+if (gIntensityDirty) {
+	buffer[bufferL++] = kRegisterGlobalIntensity;
+	buffer[bufferL++] = gIntensity;
+	gIntensityDirty = false;
+	}
+
+if (bufferL == 0) return;
+
+gDigitsFrameL = bufferL;
+
+#if DISPLAY_SYNC_FRAMES
+	// leave it to the Start-of-Frame handler
+	/* Unless the bus is suspended: then there are no frames. */
+	if (!UCONbits.SUSPND) {
+		gDigitsState = kDigitsWaiting;
+		return;
+		}
+	#endif
+
+// send SPI commands to MAX 6954 to display
+gDigitsState = kDigitsSending;
+SPIStartExchange(buffer, bufferL, DisplayDigitsSent);
+}
+
+
+#if DISPLAY_SYNC_FRAMES
+	#if DISPLAY_SYNC_FRAMES & (DISPLAY_SYNC_FRAMES - 1) || DISPLAY_SYNC_FRAMES > 128
+		#error DISPLAY_SYNC_FRAMES must be 0, or a power of two up to 128
+		#endif
+	
+	/*	DisplayStartOfFrame
+		Commit the waiting frame of digit commands, if this is a frame to do
+		that on
+		
+		Only to be called from the high priority interrupt handler, with the
+		Start-of-Frame interrupt enabled.
+	*/
+	void DisplayStartOfFrame()
+	{
+	if (gDigitsState != kDigitsWaiting || UFRML % DISPLAY_SYNC_FRAMES) return;
+	
+	gDigitsState = kDigitsSending;
+	SPIStartExchange(gDigitsFrame, gDigitsFrameL, DisplayDigitsSent);
+	}
+	#endif
+
+
+/*	DisplayDigitsSent
+	The frame of digit commands has been sent; send whatever changed since
+*/
+static void DisplayDigitsSent()
+{
+gDigitsState = kDigitsIdle;
+
+DisplayDigits();
+}
+
+
+/*	BinaryToDecimal
+	Convert the given value to six decimal digits, most significant first
+	
+	Repeated subtraction of powers of ten instead of % 10 and / 10: the PIC18
+	has no divide instruction, and XC8 implements 24-bit division as a library
+	call that iterates over every bit.  Here, each digit takes at most nine
+	subtractions; and the arithmetic narrows to 16 and then 8 bits as soon as
+	the remainder fits.  Worst case (999999) is 45 compare-and-subtract steps.
+	
+	Counting the instructions for those steps: a 24-bit step (compare, branch,
+	increment, subtract) is about 17 cycles; 16-bit, 13; 8-bit, 10; and each
+	loop exit another 6 to 10.  So the worst case is 2 × (9 × 17 + 10) +
+	2 × (9 × 13 + 8) + (9 × 10 + 6) + about 20 for the call and the stores,
+	about 690 instruction cycles (345 µs).  PROFILE measures DisplayValues,
+	which converts twice.  test/TestDecimal checks every 20-bit value.
+	
+	Values of 1000000 and up (a 20-bit report can hold up to 1048575) give a
+	most significant 'digit' of 10, which the MAX hexadecimal decoder shows as
+	'A' rather than silently wrapping.
+*/
+static void BinaryToDecimal(
+	__uint24	v,
+	char		digits[6]
+	)
+{
+char d;
+
+for (d = 0; v >= 100000; v -= 100000) d++;
+digits[0] = d;
+
+for (d = 0; v >= 10000; v -= 10000) d++;
+digits[1] = d;
+
+// remainder fits in 16 bits
+uint16_t w = (uint16_t) v;
+
+for (d = 0; w >= 1000; w -= 1000) d++;
+digits[2] = d;
+
+for (d = 0; w >= 100; w -= 100) d++;
+digits[3] = d;
+
+// remainder fits in 8 bits
+uint8_t b = (uint8_t) w;
+
+for (d = 0; b >= 10; b -= 10) d++;
+digits[4] = d;
+
+digits[5] = b;
+}
+
+
+/*	DisplayIntensity
+	Set the brightness of all digits, from 0 (dimmest) to 15 (brightest)
+	[MAX: Intensity Control]
+*/
+void DisplayIntensity(
+	uint8_t		intensity
+	)
+{
+// out of range?
+if (intensity > 0x0F) intensity = 0x0F;
+
+if (intensity != gIntensity) {
+	gIntensity = intensity;
+	gIntensityDirty = true;
+	}
+
+// goes out with the next frame of digits
+DisplayDigits();
+}
+
+
 /*	DisplayValues
 	Cause the given values to be displayed
+	
+	Only the digits that differ from what is already displayed are sent.
 */
 void DisplayValues(
 	__uint24	v0,
 	__uint24	v1
 	)
 {
+#if PROFILE
+	const uint16_t start = Timer1Read();
+	#endif
+
 gValue0 = v0;
 gValue1 = v1;
 
-static char buffer[24];
-buffer[ 0] = kRegisterDigit0Plane0 + 5;
-buffer[ 1] = v0 % 10; v0 /= 10;
-buffer[ 2] = kRegisterDigit0Plane0 + 4;
-buffer[ 3] = v0 % 10; v0 /= 10;
-buffer[ 4] = kRegisterDigit0Plane0 + 3;
-buffer[ 5] = v0 % 10; v0 /= 10;
-buffer[ 6] = kRegisterDigit0Plane0 + 2;
-buffer[ 7] = (v0 % 10) | 0x80; v0 /= 10;	// with decimal point
-buffer[ 8] = kRegisterDigit0Plane0 + 1;
-buffer[ 9] = v0 % 10; v0 /= 10;
-buffer[10] = kRegisterDigit0Plane0 + 0;
-buffer[11] = v0 % 10;
-
-buffer[12] = kRegisterDigit0APlane0 + 5;
-buffer[13] = v1 % 10; v1 /= 10;
-buffer[14] = kRegisterDigit0APlane0 + 4;
-buffer[15] = v1 % 10; v1 /= 10;
-buffer[16] = kRegisterDigit0APlane0 + 3;
-buffer[17] = v1 % 10; v1 /= 10;
-buffer[18] = kRegisterDigit0APlane0 + 2;
-buffer[19] = (v1 % 10) | 0x80; v1 /= 10;	// with decimal point
-buffer[20] = kRegisterDigit0APlane0 + 1;
-buffer[21] = v1 % 10; v1 /= 10;
-buffer[22] = kRegisterDigit0APlane0 + 0;
-buffer[23] = v1 % 10;
+char digits[kDigitsN];
+BinaryToDecimal(v0, digits + 0);
+BinaryToDecimal(v1, digits + 6);
 
-// send SPI commands to MAX 6954 to display
-SPIStartExchange(buffer, sizeof buffer, NULL);
+// decimal points
+digits[2] |= 0x80;
+digits[8] |= 0x80;
+
+// update the shadow copy and note which digits changed
+uint16_t mask = 1;
+for (uint8_t d = 0; d < kDigitsN; d++, mask <<= 1)
+	if (digits[d] != gDigits[d]) {
+		gDigits[d] = digits[d];
+		gDigitsDirty |= mask;
+		}
+
+DisplayDigits();
+
+#if PROFILE
+	ProfileRecord(kProfileDisplayValues, start);
+	#endif
 }
 
 
-/*	gReadKeyADebounced
-	Before SPI exchange: the command to read the Key A Debounced register;
-	after the exchange completed, the value of that register
+/*	gReadKeys
+	Before SPI exchange: the commands to read the four Key Debounced registers,
+	followed by a No-Op; after the exchange completed, the values of those
+	registers
+	
+	[MAX: Reading Device Registers] The register addressed by a read command
+	is shifted out during the *next* 16-bit command; so the value of Key
+	Debounced register n arrives in the data byte of command n + 1.  Chaining
+	the reads like this gets all 32 keys in five commands (one exchange, one
+	callback) instead of two commands per register.
 */
-static char gReadKeyADebounced[2];
+static char gReadKeys[2 * (4 + 1)];
 
 
-/*	ReadDebouncedKeyA
- 
+/*	gKeysScanning
+	A scan is on (or queued for) the SPI bus; and whether another one was
+	asked for in the meantime
+	
+	The MAX keeps IRQ low until the Debounced registers are read; a key that
+	is pressed after the scan has read them gets a new interrupt, but that
+	interrupt may arrive before the scan completes.
+*/
+static bool gKeysScanning, gKeysRescan;
+
+
+/*	gKeysTime
+	When the scan in progress started; i.e., (shortly after) the IRQ
 */
-static void ReadDebouncedKeyA()
+static Timestamp gKeysTime;
+
+
+static void ReadKeys(void);
+
+
+/*	ScanKeys
+	Read the keys from the MAX
+*/
+static void ScanKeys()
 {
-// *** if key pressed
+// only one scan at a time, since they share the buffer
+if (gKeysScanning) { gKeysRescan = true; return; }
+
+for (uint8_t r = 0; r < 4; r++) {
+	gReadKeys[2 * r] = 0x80 | (kRegisterKeyAMaskDebounce + r);
+	gReadKeys[2 * r + 1] = 0 /* dummy */;
+	}
 
-// swap the two displayed values
-DisplayValues(gValue1, gValue0);
+// clocks out the value of the last register
+gReadKeys[8] = kRegisterNoOperation;
+gReadKeys[9] = 0;
+
+// transfer MAX 6954 read commands
+GetTimestamp(&gKeysTime);
+gKeysScanning = true;
+SPIStartExchange(gReadKeys, sizeof gReadKeys, ReadKeys);
+}
+
+
+/*	ReadKeys
+	The Key Debounced registers were read
+*/
+static void ReadKeys()
+{
+gKeysScanning = false;
+
+#if TRACE
+	Trace(PORTBbits.RB2 ? kTraceKeysRead : kTraceKeysReadIRQLow);
+	#endif
+
+// assemble the key bitmap
+/* Bytewise; the PIC18 has no barrel shifter */
+uint32_t keys;
+((uint8_t*) &keys)[0] = gReadKeys[3];
+((uint8_t*) &keys)[1] = gReadKeys[5];
+((uint8_t*) &keys)[2] = gReadKeys[7];
+((uint8_t*) &keys)[3] = gReadKeys[9];
+
+// keys that went down since the previous scan
+const uint32_t pressed = keys & ~gKeys;
+gKeys = keys;
+
+// look again while keys are down
+if (keys) TimerStart(&gKeysPollTimer, ScanKeys, kKeysPollPeriod, 0);
+
+// Key A 0 swaps the two displayed values
+if (pressed & 1) DisplayValues(gValue1, gValue0);
+
+// Key A 1 switches the encoder between 25 and 8.33 kHz channels
+if (pressed & 2) gChannelSpacing833 = !gChannelSpacing833;
 
 // send back to host
-SendValues(gValue0, gValue1);
+/* All the keys pressed since the previous scan go in one report */
+SendReport(gValue0, gValue1, pressed, &gKeysTime);
+
+// an interrupt arrived while we were scanning?
+if (gKeysRescan) {
+	gKeysRescan = false;
+	ScanKeys();
+	}
 }
 
 
@@ -240,11 +600,10 @@ SendValues(gValue0, gValue1);
 */
 void ControlsServiceInterrupt()
 {
-// read Key A debounced
-gReadKeyADebounced[0] = 0x80 | (kRegisterKeyAMaskDebounce + 0);
-gReadKeyADebounced[1] = 0 /* dummy */;
+#if TRACE
+	Trace(kTraceIRQ);
+	#endif
 
-// transfer MAX 6954 read commands
-SPIStartExchange(gReadKeyADebounced, sizeof gReadKeyADebounced, ReadDebouncedKeyA);
+// scan from main(), not in interrupt context
+TaskPost(kTaskFromLow, ScanKeys);
 }
-
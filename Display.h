@@ -15,7 +15,27 @@
 #pragma once
 
 
+/*	DISPLAY_SYNC_FRAMES
+	If not 0, changes to the display wait for the Start-of-Frame of the next
+	USB frame whose number is a multiple of this (1, 2, 4, ... 128 ms at full
+	speed), rather than going out as soon as they are made
+	
+	Select at build time in the project's preprocessor macros.  The time from
+	a change to the display becomes a fixed number of frames, whatever the USB
+	scheduling; and panels attached to the same host (hence seeing the same
+	frame numbers) change together.  This costs a Start-of-Frame interrupt
+	every 1 ms.
+*/
+#if !defined(DISPLAY_SYNC_FRAMES)
+	#define DISPLAY_SYNC_FRAMES 0
+	#endif
+
+
 extern void DisplayInitialize(void);
 extern void DisplayTerminate(void);
 extern void ControlsServiceInterrupt(void);
+extern void DisplayIntensity(uint8_t);
+extern void DisplayStartOfFrame(void);
 extern void DisplayValues(__uint24, __uint24);
+
+extern __uint24 gValue0, gValue1;
@@ -12,9 +12,24 @@
 		[PIC] Microchip PIC18(L)F2X/45K50 Data Sheet
 */
 
+#include <stdbool.h>
+
 #include <xc.h>
 
 #include "LED.h"
+#include "Timer.h"
+
+
+/*	gBlinkTimer
+	Blinks LED 0 at 1 s, to show the firmware is running
+*/
+static Timer gBlinkTimer;
+
+
+static void Blink()
+{
+LATDbits.LATD0 = !PORTDbits.RD0;
+}
 
 
 /*	LEDInitialize
@@ -38,4 +53,6 @@ LATDbits.LATD0 = 1;
 LATDbits.LATD1 = 1;
 LATDbits.LATD2 = 1;
 LATDbits.LATD3 = 1;
+
+TimerStart(&gBlinkTimer, Blink, 1000, 1000);
 }
@@ -0,0 +1,124 @@
+/*
+	Profile
+	
+	Instruction cycle counts of the hot paths
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+ 	References:
+		[HID] Device Class Definition for Human Interface Devices (HID) Version 1.11
+		[PIC] Microchip PIC18(L)F2X/45K50 Data Sheet
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Profile.h"
+#include "Timer1.h"
+#include "USBEndpoint1.h"
+
+
+/*	gProfile
+	Statistics of each timed path since start-up (or ProfileReset)
+*/
+ProfileStats gProfile[kProfileN];
+
+
+/*	ProfileReset
+	Forget the statistics collected so far; e.g., before starting a workload
+*/
+void ProfileReset()
+{
+const bool interrupts = INTCONbits.GIE;
+INTCONbits.GIE = 0;
+
+// the minimum is set by the first call recorded
+for (uint8_t p = 0; p < kProfileN; p++) {
+	gProfile[p].max = 0;
+	gProfile[p].total = 0;
+	gProfile[p].count = 0;
+	}
+
+INTCONbits.GIE = interrupts;
+}
+
+
+/*	GetProfileReport
+	Put the statistics in a Feature report [HID §7.2.1]
+*/
+void GetProfileReport(
+	uint8_t		*buffer
+	)
+{
+buffer[0] = kReportIDProfile;
+
+// keep the interrupt handlers from updating the statistics while we copy them
+const bool interrupts = INTCONbits.GIE;
+INTCONbits.GIE = 0;
+
+const uint8_t *from = (const uint8_t*) gProfile;
+for (uint8_t i = 1; i < kProfileReportLength; i++)
+	buffer[i] = *from++;
+
+INTCONbits.GIE = interrupts;
+}
+
+
+/*	PutProfileReport
+	Forget the statistics, at the host's request (a Feature report [HID §7.2.2]
+	of just the report ID)
+	
+	Gives whether it was that report; anything else is refused.
+*/
+bool PutProfileReport(
+	const volatile uint8_t *report
+	)
+{
+if (report[0] != kReportIDProfile) return false;
+
+ProfileReset();
+return true;
+}
+
+
+/*	ProfileRecord
+	Account for one call of the given path, which started at the given
+	Timer1Read(); or for a latency, when the condition flag was set
+	
+	Paths run outside the high priority interrupt handler also include the
+	time spent in any interrupt that arrived meanwhile; so their maximum is
+	only an upper bound.
+*/
+void ProfileRecord(
+	uint8_t		path,
+	uint16_t	start
+	)
+{
+// the subtraction is modulo 65536, like the clock
+/* The resolution is kCyclesPerMicrosecond; and the reading of the clock
+   itself is part of the cost. */
+const uint16_t cycles = (uint16_t) (Timer1Read() - start) * kCyclesPerMicrosecond;
+
+/* This can be called from main-line code and from the interrupt handler;
+   keep the latter out while updating the statistics. */
+const bool interrupts = INTCONbits.GIE;
+INTCONbits.GIE = 0;
+
+ProfileStats *const stats = &gProfile[path];
+
+// nothing recorded yet?
+if (stats->count == 0) stats->min = 0xFFFF;
+
+if (cycles < stats->min) stats->min = cycles;
+if (cycles > stats->max) stats->max = cycles;
+
+// keep the average consistent once the count saturates
+if (stats->count != 0xFFFF) {
+	stats->total += cycles;
+	stats->count++;
+	}
+
+INTCONbits.GIE = interrupts;
+}
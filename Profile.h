@@ -0,0 +1,70 @@
+/*
+	Profile
+	
+	Instruction cycle counts of the hot paths
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#pragma once
+
+
+/*	PROFILE
+	Whether the hot paths are timed against the Timer 1 µs clock, and their
+	minimum, average and maximum cost collected in gProfile
+	
+	Select at build time by defining PROFILE as 1 in the project's preprocessor
+	macros.  The statistics can then be inspected in the debugger; or read by
+	the host as a Feature report (see kReportIDProfile), as tools/Benchmark
+	does after running its fixed workload.  This costs two Timer 1 reads and
+	a few dozen cycles of bookkeeping per timed call.
+*/
+#if !defined(PROFILE)
+	#define PROFILE 0
+	#endif
+
+
+/*	ProfilePath
+	The paths that are timed; and the interrupt latencies, from when the
+	condition flag was set to when its handler starts
+*/
+enum {
+	kProfileUSBInterrupt,				// USBInterruptService
+	kProfileSPIInterrupt,				// SPIServiceInterrupt
+	kProfileDisplayValues,				// DisplayValues
+	kProfileEndpoint0SETUP,				// HandleEndpoint0SETUP
+	kProfileSPILatency,				// SSPIF, high priority (see gSPIByteDone)
+	kProfileTickLatency,				// TMR2IF, low priority (see Timer2Match)
+	kProfileN
+	};
+
+
+/*	ProfileStats
+	Instruction cycles spent in a path (or waiting for a handler)
+	
+	The average is total / count.  The total stops when count would overflow.
+*/
+typedef struct {
+	uint16_t	min;
+	uint16_t	max;
+	uint32_t	total;
+	uint16_t	count;
+	} ProfileStats;
+
+
+/*	kProfileReportLength
+	Report ID, and gProfile (little-endian)
+	
+	The host resets the statistics with a Feature report of just the report
+	ID.
+*/
+enum { kProfileReportLength = 1 + kProfileN * sizeof (ProfileStats) };
+
+
+extern ProfileStats gProfile[kProfileN];
+
+extern void GetProfileReport(uint8_t *);
+extern void ProfileRecord(uint8_t, uint16_t);
+extern void ProfileReset(void);
+extern bool PutProfileReport(const volatile uint8_t *);
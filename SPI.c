@@ -12,9 +12,16 @@
 		[PIC] Microchip PIC18(L)F2X/45K50 Data Sheet
 */
 
+#include <stdbool.h>
+
 #include <xc.h>
 
+#include "Counters.h"
+#include "Profile.h"
 #include "SPI.h"
+#include "Task.h"
+#include "Timer1.h"
+#include "Trace.h"
 
 
 extern void Error(void);
@@ -32,7 +39,7 @@ SSP1STAT = 0;
 SSP1CON1 = 0;
 
 // SPI master Fosc / 4
-/* 8 MHz system clock  4 = 2MHz SCK ? 500 ns clock period;
+/* 8 MHz system clock ÷ 4 = 2MHz SCK ? 500 ns clock period;
    this is much greater than MAX6954 minimum clock period 38.4 ns */
 SSP1CON1bits.SSPM = 0;
 
@@ -64,6 +71,7 @@ LATAbits.LATA5 = 1;			// high is deselect
 TRISAbits.RA5 = 0;			// output
 
 // enable interrupts
+IPR1bits.SSPIP = 1;			// high priority
 PIE1bits.SSPIE = 1;
 
 // enable module
@@ -71,21 +79,100 @@ SSP1CON1bits.SSPEN = 1;
 }
 
 
+/*	SPIExchange
+	An exchange waiting for, or occupying, the SPI bus
+*/
+typedef struct {
+	char		*data;
+	uint8_t		dataL;
+	void		(*callback)(void);
+	} SPIExchange;
+
+
+/*	gSPIQueue
+	Exchanges in order of submission; the one at the head is on the bus
+	
+	The length must be a power of two.  Four is the most there can be: the
+	exchanges with a callback are a frame of digits and a key scan, of which
+	Display only ever has one each outstanding; and the write-only
+	(re)configurations of the MAX take up at most one entry besides the one
+	on the bus, however often the host selects or deselects the configuration
+	(see SPIStartExchange).
+*/
+enum { kSPIQueueLength = 4 };
+
+static SPIExchange gSPIQueue[kSPIQueueLength];
+static uint8_t gSPIQueueHead, gSPIQueueN;
+
+
 /*	gSPIData
-	Data to send
+	Progress of the exchange at the head of the queue
 */
-static void (*gSPICallback)();
 static char *gSPIData;
 static uint8_t gSPIDataL;
 
 
+#if PROFILE
+	/*	gSPIByteDone
+		The µs clock when the byte on the bus will have been shifted out,
+		and SSPIF set: 8 SCK periods at 2 MHz after it was written (see
+		SPIInitialize)
+		
+		Read just before the write; so the latency measured against it is
+		over by the few cycles in between, rather than under.
+	*/
+	enum { kSPIByteTime = 4 /* µs */ };
+	
+	uint16_t gSPIByteDone;
+	#endif
+static bool gSPIWriteBack;
+
+
+/*	SPIStartHead
+	Put the exchange at the head of the queue on the bus
+*/
+static void SPIStartHead()
+{
+const SPIExchange *const exchange = &gSPIQueue[gSPIQueueHead];
+
+// any previously received data should already have been removed
+if (SSP1STATbits.BF) Error();
+
+// the previous exchange should have ended its last command
+if (!LATAbits.LATA5) Error();
+
+gSPIData = exchange->data;
+gSPIDataL = exchange->dataL;
+
+/* Without a callback, nobody is interested in the data that comes back; so
+   leave the buffer alone.  The caller can then safely submit the same buffer
+   again while this exchange is still queued. */
+gSPIWriteBack = exchange->callback != NULL;
+
+#if TRACE
+	Trace(kTraceSPIStart);
+	#endif
+
+// enable SPI slave Chip Select
+LATAbits.LATA5 = 0;
+
+// send first byte
+#if PROFILE
+	gSPIByteDone = Timer1Read() + kSPIByteTime;
+	#endif
+SSP1BUF = *gSPIData;
+}
+
+
 /*	SPIServiceInterrupt
 	Byte was sent
 */
 void SPIServiceInterrupt()
 {
-// store exchanged data in buffer
-*gSPIData++ = SSP1BUF, --gSPIDataL;
+// store exchanged data in buffer (reading SSP1BUF clears BF regardless)
+uint8_t received = SSP1BUF;
+if (gSPIWriteBack) *gSPIData = received;
+++gSPIData, --gSPIDataL;
 
 // end of two-byte MAX command?
 if (gSPIDataL % 2 == 0)
@@ -100,62 +187,112 @@ if (gSPIDataL) {
 		LATAbits.LATA5 = 0;
 	
 	// send next byte
+	#if PROFILE
+		gSPIByteDone = Timer1Read() + kSPIByteTime;
+		#endif
 	SSP1BUF = *gSPIData;
 	}
 
 // buffer exchange completed
 else {
-	// no more data to send
-	gSPIData = NULL;
+	#if TRACE
+		Trace(kTraceSPIDone);
+		#endif
 	
-	// notify caller
-	if (gSPICallback) {
-		// clear global state so the callback can schedule another transfer
-		void (*callback)(void) = gSPICallback;
-		gSPICallback = NULL;
-		
-		// call back
-		(*callback)();
-		}
+	// retire the exchange at the head of the queue
+	void (*callback)(void) = gSPIQueue[gSPIQueueHead].callback;
+	gSPIQueueHead = (gSPIQueueHead + 1) % kSPIQueueLength;
 	
+	// chain straight into the next exchange so the bus doesn't idle
+	/* CS has just been raised above; the few instructions until it is lowered
+	   again are well over the MAX6954 minimum CS high time. */
+	if (--gSPIQueueN)
+		SPIStartHead();
+	
+	else
+		// no more data to send
+		gSPIData = NULL;
+	
+	// notify caller (who may submit another exchange), from main()
+	if (callback)
+		TaskPost(kTaskFromHigh, callback);
 	}
 }
 
 
 /*	SPIStartExchange
 	SPI fundamentally rotates bytes from the master into a chain of slaves;
-	The data in the given array is pushed out; data that arrives back is
-	stored back and replaces the original data in the array
+	The data in the given array is pushed out; if there is a callback, data
+	that arrives back is stored back and replaces the original data in the array
+	
+	If the bus is busy, the exchange is queued behind the ones already
+	submitted.  The data must remain valid until the exchange completes.
+	The callback runs as a task (not in interrupt context).
 	
-	***** if no callback, then also no writeback?
+	An exchange without a callback replaces one without a callback that is
+	still waiting: those only configure the MAX, and only the latest
+	configuration matters.
 */
 void SPIStartExchange(
 	char		*data,
 	uint8_t		dataL,
-	void		(*callback)()
+	void		(*callback)(void)
 	)
 {
-// should not be an exchange in progress already
-/* This can happen when we're servicing an interrupt for a keypress and sending
-   SPI commands to clear interrupt; and at the same time receiving a output report
-   from USB.  I think the odds of this happening are minuscule; but it would be nice
-   if we handled it properly (at least sending STALL back to USB). */
-if (gSPIData) { Error(); return; }
-
 // we're not optimizing for the special case of a zero-length exchange
-if (dataL == 0) Error();
+if (dataL == 0) { Error(); return; }
 
-// any previously received data should already have been removed
-if (SSP1STATbits.BF) Error();
+// MAX commands are 16 bits
+/* SPIServiceInterrupt raises CS after every second byte; with an odd length,
+   the last command would be cut off and the next exchange would start in the
+   middle of one [MAX: Serial Interface]. */
+if (dataL % 2) { Error(); return; }
 
-// data to exchange
-gSPICallback = callback;
-gSPIData = data;
-gSPIDataL = dataL;
+/* This can be called from the interrupt handlers as well as from main-line
+   code; keep interrupts out while the queue is inconsistent.  Restore rather
+   than set GIE, so that we don't enable interrupts inside the handler.
+   With priority levels enabled, GIE is GIEH: clearing it keeps out both
+   the high and the low priority handlers. */
+const bool interrupts = INTCONbits.GIE;
+INTCONbits.GIE = 0;
 
-// enable SPI slave Chip Select
-LATAbits.LATA5 = 0;
+// replace a configuration still waiting?
+/* Not the one at the head, which is already on the bus */
+bool replaced = false;
+if (!callback)
+	for (uint8_t n = 1; n < gSPIQueueN; n++) {
+		SPIExchange *const waiting = &gSPIQueue[(gSPIQueueHead + n) % kSPIQueueLength];
+		if (!waiting->callback) {
+			waiting->data = data;
+			waiting->dataL = dataL;
+			replaced = true;
+			break;
+			}
+		}
 
-// send first byte
-SSP1BUF = *gSPIData;
-}
\ No newline at end of file
+if (replaced)
+	;
+
+// queue full?
+/* This would be a design error: the queue is sized for all the exchanges
+   that can be outstanding at the same time. */
+else if (gSPIQueueN == kSPIQueueLength)
+	Error();
+
+else {
+	// append the exchange
+	SPIExchange *const exchange = &gSPIQueue[(gSPIQueueHead + gSPIQueueN) % kSPIQueueLength];
+	exchange->data = data;
+	exchange->dataL = dataL;
+	exchange->callback = callback;
+	
+	// bus idle?
+	if (gSPIQueueN++ == 0)
+		SPIStartHead();
+	
+	else
+		gCounters.spiWaited++;
+	}
+
+INTCONbits.GIE = interrupts;
+}
@@ -17,4 +17,6 @@
 
 extern void SPIInitialize(void);
 extern void SPIServiceInterrupt(void);
-extern void SPIStartExchange(char *data, uint8_t dataL, void (*)());
+extern void SPIStartExchange(char *data, uint8_t dataL, void (*)(void));
+
+extern uint16_t gSPIByteDone;
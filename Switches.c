@@ -1,15 +1,52 @@
 /*
 	Switches
 	
-	PICDEM push-button switches
+	PICDEM push-button switches; or a quadrature rotary encoder on the same pins
 	Microchip PIC18 USB Radio Panel firmware
 	
 	2024/10/27	Factored
+	
+ 	References:
+		[PIC] Microchip PIC18(L)F2X/45K50 Data Sheet
 */
 
+#include <stdbool.h>
+
 #include <xc.h>
 
+#include "Display.h"
 #include "Switches.h"
+#include "Task.h"
+#include "Timer1.h"
+#include "Timer2.h"
+#include "USBEndpoint1.h"
+
+
+/*	kEncoderTransitions
+	Quadrature decoder state machine; indexed by the previous and the current
+	state of the channels (A in bit 1, B in bit 0)
+	
+	+1 for a quarter step clockwise, -1 for one counter-clockwise.  0 for no
+	change, or for a change of both channels at once: that means an edge was
+	missed (or is contact bounce), and we can't tell the direction.  Bounce on
+	one channel just steps back and forth between two adjacent states.
+*/
+static const int8_t kEncoderTransitions[16] = {
+	 0, -1, +1,  0,
+	+1,  0,  0, -1,
+	-1,  0,  0, +1,
+	 0, +1, -1,  0
+	};
+
+
+/*	kEncoderDetent
+	Quarter steps from one detent to the next (one full quadrature cycle)
+*/
+enum { kEncoderDetent = 4 };
+
+
+static uint8_t gEncoderState;
+static int8_t gEncoderQuarters;
 
 
 /*	SwitchesInitialize
@@ -24,19 +61,182 @@ ANSELBbits.ANSB5 = 0;			// digital
 TRISBbits.RB4 = 1;			// input
 TRISBbits.RB5 = 1;			// input
 
+// encoder contacts switch to ground
+WPUBbits.WPUB4 = 1;			// enable pull-up
+WPUBbits.WPUB5 = 1;			// enable pull-up
+
+// start the decoder from where the encoder is resting
+gEncoderState = (uint8_t) (PORTBbits.RB4 << 1 | PORTBbits.RB5);
+
 // enable interrupts
 IOCBbits.IOCB4 = 1;			// interrupt-on-change RB4 enabled
 IOCBbits.IOCB5 = 1;			// interrupt-on-change RB5 enabled
+INTCON2bits.IOCIP = 0;			// low priority
 INTCONbits.IOCIE = 1;			// interrupt-on-change enabled
 }
 
 
+/*	gEncoderDetentTicks
+	Timer tick at the previous detent, for the velocity
+*/
+static uint16_t gEncoderDetentTicks;
+
+
+/*	gEncoderSteps
+	Channel steps taken by the encoder that the task hasn't applied yet; and
+	whether the task is posted
+*/
+static int8_t gEncoderSteps;
+static bool gEncoderPosted;
+
+
+/*	gEncoderTime
+	When the first of the steps not yet applied was taken
+*/
+static Timestamp gEncoderTime;
+
+
+/*	kCOM
+	VHF COM band, in kHz as displayed
+*/
+enum {
+	kCOMLowest = 118000,
+	kCOMHighest25 = 136975,
+	kCOMHighest833 = 136990
+	};
+
+
+/*	gChannelSpacing833
+	Step through the 8.33 kHz channel names (118.005, 118.010, 118.015,
+	118.025, ...) rather than the 25 kHz channels
+	
+	8.33 kHz channels are named by the 25 kHz channel they fall in, plus 5, 10,
+	or 15; and the 25 kHz channel itself (ending in 0 or 5) is a valid name too.
+	So in each 25 kHz block there are names at offsets 0, 5, 10, and 15.
+*/
+bool gChannelSpacing833;
+
+
+/*	ChannelUp
+	The next channel above the given frequency; wrapping around the band
+*/
+static __uint24 ChannelUp(
+	__uint24	v
+	)
+{
+const uint8_t r = (uint8_t) (v % 25);
+
+if (gChannelSpacing833) {
+	v += r >= 15 ? 25 - r : 5 - r % 5;
+	if (v > kCOMHighest833) v = kCOMLowest;
+	}
+
+else {
+	v += 25 - r;
+	if (v > kCOMHighest25) v = kCOMLowest;
+	}
+
+return v;
+}
+
+
+/*	ChannelDown
+	The next channel below the given frequency; wrapping around the band
+*/
+static __uint24 ChannelDown(
+	__uint24	v
+	)
+{
+const uint8_t r = (uint8_t) (v % 25);
+
+if (gChannelSpacing833) {
+	v -= r == 0 ? 10 : r % 5 ? r % 5 : 5;
+	if (v < kCOMLowest) v = kCOMHighest833;
+	}
+
+else {
+	v -= r ? r : 25;
+	if (v < kCOMLowest) v = kCOMHighest25;
+	}
+
+return v;
+}
+
+
+/*	StepFrequency
+	Apply the steps taken by the encoder to the standby frequency
+	
+	Runs as a task: the display and the report are too much work for the
+	interrupt handler.  Steps that arrive in the meantime accumulate, and are
+	applied together.
+*/
+static void StepFrequency()
+{
+// take the steps
+INTCONbits.GIEL = 0;
+int8_t steps = gEncoderSteps;
+const Timestamp time = gEncoderTime;
+gEncoderSteps = 0;
+gEncoderPosted = false;
+INTCONbits.GIEL = 1;
+
+__uint24 v = gValue1;
+
+// not tuned to the COM band yet?
+if (v < kCOMLowest || v > kCOMHighest833) v = kCOMLowest;
+
+for (; steps > 0; steps--) v = ChannelUp(v);
+for (; steps < 0; steps++) v = ChannelDown(v);
+
+// show right away
+DisplayValues(gValue0, v);
+
+// and tell the host
+SendReport(gValue0, gValue1, 0, &time);
+}
+
+
 /*	SwitchesInterruptService
- 
+	A switch (encoder channel) changed
 */
 void SwitchesInterruptService()
 {
+// reading PORTB ends the mismatch condition [PIC: Interrupt-on-Change]
+const uint8_t a = PORTBbits.RB4, b = PORTBbits.RB5;
+
 // set LEDs according to switch state
-LATDbits.LATD2 = PORTBbits.RB4;
-LATDbits.LATD3 = PORTBbits.RB5;
+LATDbits.LATD2 = a;
+LATDbits.LATD3 = b;
+
+// advance the quadrature decoder
+const uint8_t state = (uint8_t) (a << 1 | b);
+gEncoderQuarters += kEncoderTransitions[gEncoderState << 2 | state];
+gEncoderState = state;
+
+// reached a detent?
+int8_t direction;
+if (gEncoderQuarters >= kEncoderDetent) direction = +1;
+else if (gEncoderQuarters <= -kEncoderDetent) direction = -1;
+else return;
+
+gEncoderQuarters = 0;
+
+// velocity acceleration
+/* Turning quickly steps several channels per detent; so the whole band is
+   a few turns away, yet slow turns still step one channel at a time. */
+const uint16_t interval = gTimer2Ticks - gEncoderDetentTicks;
+gEncoderDetentTicks = gTimer2Ticks;
+
+int8_t steps = interval < 30 ? 10 : interval < 80 ? 4 : 1;
+if (direction < 0) steps = -steps;
+
+// accumulate (within the range of the counter) until the task runs
+if (gEncoderSteps + steps > -100 && gEncoderSteps + steps < 100)
+	gEncoderSteps += steps;
+
+if (!gEncoderPosted) {
+	GetTimestamp(&gEncoderTime);
+	gEncoderPosted = true;
+	TaskPost(kTaskFromLow, StepFrequency);
+	}
 }
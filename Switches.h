@@ -1,7 +1,7 @@
 /*
 	Switches
 	
-	PICDEM push-button switches
+	PICDEM push-button switches; or a quadrature rotary encoder on the same pins
 	Microchip PIC18 USB Radio Panel firmware
 	
 	2024/10/27	Factored
@@ -12,3 +12,5 @@
 
 extern void SwitchesInitialize(void);
 extern void SwitchesInterruptService(void);
+
+extern bool gChannelSpacing833;
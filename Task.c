@@ -0,0 +1,118 @@
+/*
+	Task
+	
+	Deferred work
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+	The interrupt handlers only do what can't wait (move a byte, capture a
+	condition) and post the rest as a task: a function that main() runs to
+	completion, outside interrupt context, between SLEEPs.  That keeps the
+	handlers short, and so bounds the time any interrupt waits for another.
+	
+	Each interrupt priority level posts to its own queue; so every queue has a
+	single producer (the handler at that level) and a single consumer (main),
+	and needs no locking: the producer only writes the tail, the consumer only
+	writes the head, and both are single bytes.
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Task.h"
+
+
+extern void Error(void);
+
+
+/*	TaskQueue
+	Ring of posted tasks; empty when head and tail are equal
+	
+	The length must be a power of two.
+*/
+enum { kTaskQueueLength = 16 };
+
+typedef struct {
+	void		(*tasks[kTaskQueueLength])(void);
+	volatile uint8_t head,				// next to run
+			tail;				// next to post
+	} TaskQueue;
+
+
+/*	gTaskQueues
+	One for each of the interrupt priority levels; tasks posted from the high
+	priority level run first
+*/
+static TaskQueue gTaskQueues[2];
+
+
+/*	TaskPost
+	Have the given task run from main()
+	
+	Only to be called from the interrupt handler of the given priority level.
+*/
+void TaskPost(
+	uint8_t		source,
+	void		(*task)(void)
+	)
+{
+TaskQueue *const queue = &gTaskQueues[source];
+const uint8_t tail = queue->tail;
+const uint8_t next = (tail + 1) % kTaskQueueLength;
+
+// queue full?
+/* This would be a design error: main() can't keep up with the interrupts. */
+if (next == queue->head) { Error(); return; }
+
+// fill in the entry before publishing it
+queue->tasks[tail] = task;
+queue->tail = next;
+}
+
+
+/*	TaskPending
+	Whether there are posted tasks that haven't run yet
+*/
+bool TaskPending()
+{
+return
+	gTaskQueues[kTaskFromHigh].head != gTaskQueues[kTaskFromHigh].tail ||
+	gTaskQueues[kTaskFromLow].head != gTaskQueues[kTaskFromLow].tail;
+}
+
+
+/*	TaskRunQueue
+	Run the oldest task in the given queue, if any
+*/
+static bool TaskRunQueue(
+	TaskQueue	*queue
+	)
+{
+const uint8_t head = queue->head;
+
+// empty?
+if (head == queue->tail) return false;
+
+// take the entry before releasing it to the producer
+void (*const task)(void) = queue->tasks[head];
+queue->head = (head + 1) % kTaskQueueLength;
+
+(*task)();
+
+return true;
+}
+
+
+/*	TaskRun
+	Run one posted task, if any; those posted from high priority first
+	
+	Only to be called from main().
+*/
+bool TaskRun()
+{
+return
+	TaskRunQueue(&gTaskQueues[kTaskFromHigh]) ||
+	TaskRunQueue(&gTaskQueues[kTaskFromLow]);
+}
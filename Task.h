@@ -0,0 +1,21 @@
+/*
+	Task
+	
+	Deferred work
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#pragma once
+
+
+/*	TaskSource
+	Interrupt priority level posting the task; each has its own queue
+*/
+enum { kTaskFromHigh, kTaskFromLow };
+
+
+extern bool TaskPending(void);
+extern void TaskPost(uint8_t, void (*)(void));
+extern bool TaskRun(void);
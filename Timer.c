@@ -0,0 +1,156 @@
+/*
+	Timer
+	
+	Software timers
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+	Any number of one-shot and periodic timers share the 1 ms tick of
+	Timer 2.  The running timers are kept in a delta list: sorted by expiry,
+	each storing only the ticks after the timer before it.  So a tick only
+	has to look at the head of the list, however many timers are running;
+	starting or stopping a timer walks the list, but that's rare by comparison.
+	
+	The interrupt handler just counts the tick; the list is processed, and the
+	callbacks run, in a task.  So timers are only to be started and stopped
+	from main(), and callbacks are free to start and stop timers (including
+	their own).
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Task.h"
+#include "Timer.h"
+
+
+/*	gTimers
+	The running timers, the first to expire first
+*/
+static Timer *gTimers;
+
+
+/*	gTimerTicks
+	Ticks counted by the interrupt handler that TimerService hasn't applied
+*/
+static volatile uint8_t gTimerTicks;
+
+
+/*	TimerInsert
+	Link the given timer into the list, to expire after the given ticks
+*/
+static void TimerInsert(
+	Timer		*timer,
+	uint16_t	delay
+	)
+{
+Timer **link = &gTimers;
+
+// after all the timers that expire before, or at the same tick
+/* So timers with the same expiry run in the order they were started. */
+while (*link && (*link)->delta <= delay) {
+	delay -= (*link)->delta;
+	link = &(*link)->next;
+	}
+
+timer->delta = delay;
+timer->next = *link;
+
+// the next timer now expires relative to this one
+if (timer->next) timer->next->delta -= delay;
+
+*link = timer;
+timer->running = true;
+}
+
+
+/*	TimerStop
+	Stop the given timer, if it is running
+*/
+void TimerStop(
+	Timer		*timer
+	)
+{
+if (!timer->running) return;
+
+Timer **link = &gTimers;
+while (*link != timer) link = &(*link)->next;
+
+// the next timer now expires relative to the one before
+if (timer->next) timer->next->delta += timer->delta;
+
+*link = timer->next;
+timer->running = false;
+}
+
+
+/*	TimerStart
+	(Re)start the given timer: the callback runs after the given delay in ms,
+	and then every period ms; or only once if the period is 0
+*/
+void TimerStart(
+	Timer		*timer,
+	void		(*callback)(void),
+	uint16_t	delay,
+	uint16_t	period
+	)
+{
+TimerStop(timer);
+
+timer->callback = callback;
+timer->period = period;
+
+TimerInsert(timer, delay);
+}
+
+
+/*	TimerService
+	Apply the ticks counted since the last time; run the callbacks of the
+	timers that expired
+*/
+static void TimerService()
+{
+// take the ticks
+INTCONbits.GIEL = 0;
+uint8_t ticks = gTimerTicks;
+gTimerTicks = 0;
+INTCONbits.GIEL = 1;
+
+while (ticks--) {
+	// nothing running?
+	if (!gTimers) break;
+	
+	if (gTimers->delta) gTimers->delta--;
+	
+	// run every timer that expired at this tick
+	/* Unlink (and reinsert a periodic timer) before the callback; so that
+	   the callback finds the list consistent. */
+	while (gTimers && gTimers->delta == 0) {
+		Timer *const timer = gTimers;
+		gTimers = timer->next;
+		timer->running = false;
+		
+		if (timer->period) TimerInsert(timer, timer->period);
+		
+		(*timer->callback)();
+		}
+	}
+}
+
+
+/*	TimerTick
+	Count a 1 ms tick
+	
+	Only to be called from the Timer 2 interrupt handler.  The ticks are
+	applied by a single task, however many there are; should main() fall
+	behind by 255 ms, further ticks are lost (and timers run late).
+*/
+void TimerTick()
+{
+if (gTimerTicks == 255) return;
+
+if (gTimerTicks++ == 0)
+	TaskPost(kTaskFromLow, TimerService);
+}
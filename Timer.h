@@ -0,0 +1,28 @@
+/*
+	Timer
+	
+	Software timers
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#pragma once
+
+
+/*	Timer
+	A one-shot or periodic timer; the storage belongs to the client, and is
+	linked into the list of running timers while the timer runs
+*/
+typedef struct Timer {
+	struct Timer	*next;
+	uint16_t	delta;				// ticks after the timer before it
+	uint16_t	period;				// 0 if one-shot
+	void		(*callback)(void);
+	bool		running;
+	} Timer;
+
+
+extern void TimerStart(Timer *, void (*)(void), uint16_t, uint16_t);
+extern void TimerStop(Timer *);
+extern void TimerTick(void);
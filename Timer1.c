@@ -0,0 +1,134 @@
+/*
+	Timer1
+	
+	Microsecond clock and event timestamps
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+ 	References:
+		[USB] Universal Serial Bus Specification, Revision 2.0
+		[PIC] Microchip PIC18(L)F2X/45K50 Data Sheet
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Timer1.h"
+
+
+/*	kFramePeriod
+	µs per USB full speed frame [USB §8.4.3.1]
+*/
+enum { kFramePeriod = 1000 };
+
+
+/*	Timer1Initialize
+	Start Timer 1 as a free-running µs clock
+*/
+void Timer1Initialize()
+{
+// 8 MHz system clock; 2000 kHz instruction clock;
+// with prescaler 2000 kHz / 2 = 1 MHz timer clock
+T1CONbits.TMR1CS = 0;				// instruction clock
+T1CONbits.T1CKPS = 1;				// prescaler 1:2
+T1CONbits.RD16 = 1;				// 16-bit reads and writes
+TMR1H = 0;
+TMR1L = 0;
+T1CONbits.TMR1ON = 1;
+}
+
+
+/*	Timer1Read
+	The µs clock (modulo 65536)
+	
+	Can be called from anywhere: main-line code, either interrupt handler.
+*/
+uint16_t Timer1Read()
+{
+/* The high byte latched by one read would be replaced by a high priority
+   handler that reads the clock in between; keep it out.  Restore rather
+   than set GIEH: it is already clear in that handler. */
+const bool interrupts = INTCONbits.GIEH;
+INTCONbits.GIEH = 0;
+
+// reading the low byte latches the high byte [PIC: Timer1 16-bit Read/Write Mode]
+const uint8_t low = TMR1L;
+const uint16_t now = (uint16_t) TMR1H << 8 | low;
+
+INTCONbits.GIEH = interrupts;
+
+return now;
+}
+
+
+/*	gStartOfFrameTime
+	The µs clock at the most recent Start-of-Frame
+*/
+static uint16_t gStartOfFrameTime;
+
+
+/*	Timer1StartOfFrame
+	Note the time of a Start-of-Frame
+	
+	Only to be called from the high priority interrupt handler, with the
+	Start-of-Frame interrupt enabled.
+*/
+void Timer1StartOfFrame()
+{
+gStartOfFrameTime = Timer1Read();
+}
+
+
+/*	GetTimestamp
+	The frame, and the time into that frame, of now
+	
+	The µs into the frame are only known while the Start-of-Frame interrupt is
+	enabled; and only while there are frames (the bus is not suspended).
+	Otherwise, subframe is 0xFFFF.
+*/
+void GetTimestamp(
+	Timestamp	*timestamp
+	)
+{
+uint8_t frameH, frameL;
+bool pending;
+uint16_t now;
+
+// keep the Start-of-Frame handler out, so that its time goes with the frame
+/* Can be called from the low priority handler as well as main(); restore
+   rather than set GIEH. */
+const bool interrupts = INTCONbits.GIEH;
+INTCONbits.GIEH = 0;
+
+// sample everything within the same frame
+do {
+	frameH = UFRMH;
+	frameL = UFRML;
+	pending = UIRbits.SOFIF;
+	now = Timer1Read();
+	} while (frameL != UFRML);
+
+uint16_t subframe = now - gStartOfFrameTime;
+
+INTCONbits.GIEH = interrupts;
+
+// Start-of-Frame not handled yet? (the frame number already advanced)
+if (pending)
+	subframe = subframe >= kFramePeriod ? subframe - kFramePeriod : 0;
+
+timestamp->frame = (uint16_t) (frameH & 0x07) << 8 | frameL;
+
+// more than a frame since the Start-of-Frame?
+/* Up to 1% over (the next Start-of-Frame not handled yet, or our clock and
+   the host's disagreeing) still goes with this frame; clamped to the
+   report's Logical Maximum.  More means the Start-of-Frame went missing. */
+if (!UIEbits.SOFIE || subframe >= kFramePeriod + kFramePeriod / 100)
+	subframe = 0xFFFF;
+
+else if (subframe >= kFramePeriod)
+	subframe = kFramePeriod - 1;
+
+timestamp->subframe = subframe;
+}
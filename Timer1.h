@@ -0,0 +1,33 @@
+/*
+	Timer1
+	
+	Microsecond clock and event timestamps
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#pragma once
+
+
+/*	kCyclesPerMicrosecond
+	Instruction cycles per count of the µs clock: 2000 kHz instruction clock,
+	1 MHz timer clock
+*/
+enum { kCyclesPerMicrosecond = 2 };
+
+
+/*	Timestamp
+	When an event happened, in USB terms: the number of the frame [USB §8.4.3]
+	and the µs since its Start-of-Frame (0xFFFF if unknown)
+*/
+typedef struct {
+	uint16_t	frame;
+	uint16_t	subframe;
+	} Timestamp;
+
+
+extern void GetTimestamp(Timestamp *);
+extern void Timer1Initialize(void);
+extern uint16_t Timer1Read(void);
+extern void Timer1StartOfFrame(void);
@@ -0,0 +1,199 @@
+/*
+	Timer2
+	
+	System tick
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2024/10/27	Factored
+	
+ 	References:
+		[USB] Universal Serial Bus Specification, Revision 2.0
+		[HID] Device Class Definition for Human Interface Devices (HID) Version 1.11
+		[PIC] Microchip PIC18(L)F2X/45K50 Data Sheet
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Profile.h"
+#include "Timer.h"
+#include "Timer1.h"
+#include "Trace.h"
+#include "Timer2.h"
+
+
+/*	kTimer2Period
+	Timer 2 counts per interrupt
+	
+	8 MHz system clock; 2000 kHz instruction clock;
+	with prescaler 2000 kHz / 4 = 500 kHz timer clock; 125 counts is 250 µs,
+	and the 1:4 postscaler makes that one interrupt per 1 ms
+	
+	Timer 2 resets itself when it matches PR2 [PIC: Timer2 Module]; unlike
+	reloading Timer 0 in the handler, the period doesn't depend on how long
+	the interrupt waits to be serviced.  So the tick doesn't drift, and the
+	handler has nothing to reload.
+*/
+enum { kTimer2Period = 125 };
+
+
+/*	gTimer2Ticks
+	Free-running count of 1 ms ticks
+	
+	Only for measuring intervals (modulo 65536 ms) from the low priority
+	handlers, which can't be interrupted by this one; or from main() with
+	interrupts disabled (two bytes, written by the interrupt handler).
+*/
+volatile uint16_t gTimer2Ticks;
+
+
+/*	kTickTest
+	Self-test of the tick against the USB frames
+	
+	The host starts a frame every 1 ms ± 0.05% [USB §7.1.12], and the SIE
+	counts them in UFRMH:UFRML; so over a test period, the frames and the
+	ticks should agree.  The device clock itself has to be within ± 0.25% for
+	full speed USB to work at all [USB §7.1.11]; so with a frame of slack for
+	sampling the two counts out of phase, more than three frames difference
+	per second means the tick is wrong.
+*/
+enum {
+	kTickTestPeriod = 1000,				// ms
+	kTickTestTolerance = 3				// frames
+	};
+
+
+/*	gTickDrift
+	Frames minus ticks over the most recent test period; and the number of
+	test periods where that exceeded the tolerance
+*/
+int8_t gTickDrift;
+uint8_t gTickTestFailures;
+
+
+static Timer gTickTestTimer;
+static uint16_t gTickTestTicks, gTickTestFrame;
+static bool gTickTestValid;
+
+
+/*	TickTest
+	Compare the ticks to the USB frames since the previous test
+*/
+static void TickTest()
+{
+// take the tick count and the frame number at the same time
+/* UFRMH:UFRML can't be read atomically; read again if the frame number
+   advanced in between. */
+uint8_t frameH, frameL;
+INTCONbits.GIEH = 0;
+const uint16_t ticks = gTimer2Ticks;
+do {
+	frameH = UFRMH;
+	frameL = UFRML;
+	} while (frameH != UFRMH);
+INTCONbits.GIEH = 1;
+
+const uint16_t frame = (uint16_t) (frameH & 0x07) << 8 | frameL;
+
+// frames (modulo the 11-bit frame number) and ticks since the previous test
+const uint16_t frames = (frame - gTickTestFrame) & 0x07FF;
+const uint16_t elapsed = ticks - gTickTestTicks;
+
+gTickTestFrame = frame;
+gTickTestTicks = ticks;
+
+// there were frames all along? (not detached, nor suspended)
+if (gTickTestValid && frames) {
+	const int16_t drift = (int16_t) (frames - elapsed);
+	gTickDrift = drift < -128 ? -128 : drift > 127 ? 127 : (int8_t) drift;
+	
+	if ((drift < -kTickTestTolerance || drift > kTickTestTolerance) && gTickTestFailures != 255)
+		gTickTestFailures++;
+	}
+
+gTickTestValid = UCONbits.USBEN && !UCONbits.SUSPND;
+}
+
+
+#if PROFILE
+/*	gTimer2Match
+	The µs clock when TMR2IF was set most recently
+	
+	Timer 1 and Timer 2 count the same instruction clock; so the flag is set
+	exactly kTickPeriod of Timer 1 apart, from when it was last seen set in
+	Timer2Initialize.
+*/
+enum { kTickPeriod = 1000 /* µs */ };
+
+static uint16_t gTimer2Match;
+
+
+/*	Timer2Match
+	When TMR2IF was set, for the interrupt now being handled; to measure the
+	latency of the low priority handler (see Profile)
+	
+	Called once per tick, from the low priority handler.  If the flag was set
+	again before it was handled, that tick is lost; the latency is from the
+	most recent one.
+*/
+uint16_t Timer2Match()
+{
+const uint16_t now = Timer1Read();
+
+gTimer2Match += kTickPeriod;
+while ((int16_t) (now - gTimer2Match) >= kTickPeriod)
+	gTimer2Match += kTickPeriod;
+
+return gTimer2Match;
+}
+	#endif
+
+
+/*	Timer2Initialize
+	Initialize Timer 2
+*/
+void Timer2Initialize()
+{
+T2CONbits.T2CKPS = 1;				// prescaler 1:4
+T2CONbits.T2OUTPS = 4 - 1;			// postscaler 1:4
+PR2 = kTimer2Period - 1;			// period is PR2 + 1 counts
+TMR2 = 0;
+PIR1bits.TMR2IF = 0;
+T2CONbits.TMR2ON = 1;
+
+// busy wait until 2ms is done, for USB
+/* Interrupts aren't enabled yet; but the condition flag is still set */
+for (uint8_t ms = 0; ms < 2; ms++) {
+	while (!PIR1bits.TMR2IF);
+	PIR1bits.TMR2IF = 0;
+	}
+
+#if PROFILE
+	// the flag was just set; Timer 2 has counted (2 µs each) since
+	gTimer2Match = Timer1Read() - (uint16_t) TMR2 * 2;
+	#endif
+
+// from now on, the 1 ms system tick
+IPR1bits.TMR2IP = 0;				// low priority
+PIE1bits.TMR2IE = 1;				// note interrupts not globally enabled yet
+
+// check the tick against the USB frames
+TimerStart(&gTickTestTimer, TickTest, kTickTestPeriod, kTickTestPeriod);
+}
+
+
+/*	Timer2InterruptService
+	1 ms tick
+*/
+void Timer2InterruptService()
+{
+++gTimer2Ticks;
+
+// software timers
+TimerTick();
+
+#if TRACE
+	TraceTick();
+	#endif
+}
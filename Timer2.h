@@ -1,7 +1,7 @@
 /*
-	Timer0
+	Timer2
 	
-	Timer
+	System tick
 	Microchip PIC18 USB Radio Panel firmware
 	
 	2024/10/27	Factored
@@ -15,5 +15,11 @@
 #pragma once
 
 
-extern void Timer0Initialize(void);
-extern void Timer0InterruptService(void);
+extern void Timer2Initialize(void);
+extern void Timer2InterruptService(void);
+extern uint16_t Timer2Match(void);
+
+extern volatile uint16_t gTimer2Ticks;
+
+extern int8_t gTickDrift;
+extern uint8_t gTickTestFailures;
@@ -0,0 +1,128 @@
+/*
+	Trace
+	
+	Timestamped event trace
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Timer1.h"
+#include "Trace.h"
+
+
+/*	gTrace
+	The ring buffer; entries up to gTraceNext, and if it has wrapped around,
+	also from there on (the oldest)
+*/
+TraceEntry gTrace[kTraceLength];
+
+
+/*	gTraceNext
+	Index of the entry to record next
+*/
+static uint8_t gTraceNext;
+static bool gTraceWrapped;
+
+
+/*	gTraceStopped
+	Whether recording was stopped by the host (to read the entries)
+	
+	Recording starts at reset.
+*/
+static bool gTraceStopped;
+
+
+/*	gTraceTime
+	The µs clock at the most recent entry
+*/
+static uint16_t gTraceTime;
+
+
+/*	Trace
+	Record an event
+	
+	Called from the interrupt handlers as well as from main-line code.
+*/
+void Trace(
+	uint8_t		event
+	)
+{
+const bool interrupts = INTCONbits.GIE;
+INTCONbits.GIE = 0;
+
+if (!gTraceStopped) {
+	TraceEntry *const entry = &gTrace[gTraceNext];
+	entry->event = event;
+	entry->time = gTraceTime = Timer1Read();
+	
+	// wrapped around? (8-bit index)
+	if (++gTraceNext == 0) gTraceWrapped = true;
+	}
+
+INTCONbits.GIE = interrupts;
+}
+
+
+/*	TraceTick
+	Every 1 ms, from the interrupt handler
+	
+	Records an idle event if nothing was recorded for 32 ms (half the µs
+	clock's period); so the host can tell how many times the clock wrapped
+	around between entries.
+*/
+void TraceTick()
+{
+/* This is the low priority handler; keep the high priority one from
+   recording (and changing gTraceTime) between our reading the clock and
+   comparing. */
+const bool interrupts = INTCONbits.GIE;
+INTCONbits.GIE = 0;
+
+if (!gTraceStopped && (uint16_t) (Timer1Read() - gTraceTime) >= 0x8000)
+	Trace(kTraceIdle);
+
+INTCONbits.GIE = interrupts;
+}
+
+
+/*	TraceStop
+	Stop recording; so the host can read the entries
+	
+	Gives the index of the next entry, and whether the buffer has wrapped
+	around.
+*/
+void TraceStop(
+	uint8_t		*status
+	)
+{
+const bool interrupts = INTCONbits.GIE;
+INTCONbits.GIE = 0;
+
+gTraceStopped = true;
+status[0] = gTraceNext;
+status[1] = gTraceWrapped;
+
+INTCONbits.GIE = interrupts;
+}
+
+
+/*	TraceStart
+	Forget the entries, and (re)start recording
+*/
+void TraceStart()
+{
+const bool interrupts = INTCONbits.GIE;
+INTCONbits.GIE = 0;
+
+gTraceNext = 0;
+gTraceWrapped = false;
+gTraceTime = Timer1Read();
+gTraceStopped = false;
+
+INTCONbits.GIE = interrupts;
+}
@@ -0,0 +1,80 @@
+/*
+	Trace
+	
+	Timestamped event trace
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#pragma once
+
+
+/*	TRACE
+	Whether the events below are recorded, with the Timer 1 µs clock, in a
+	ring buffer that the host can read through vendor requests on Endpoint 0
+	
+	Select at build time by defining TRACE as 1 in the project's preprocessor
+	macros.  This costs 768 bytes of RAM, and a Timer 1 read per event.
+*/
+#if !defined(TRACE)
+	#define TRACE 0
+	#endif
+
+
+/*	kTraceEvent
+	What happened
+	
+	The USB events are recorded when they are handled (from main()), not
+	when the SIE completed them.
+*/
+enum {
+	kTraceIdle = 1,				// nothing happened for 32 ms (see TraceTick)
+	kTraceOUTReceived,			// a report was received on Endpoint 1 OUT
+	kTraceINArmed,				// a report was offered on Endpoint 1 IN
+	kTraceINSent,				// the host collected a report from Endpoint 1 IN
+	kTraceSPIStart,				// an SPI exchange went on the bus
+	kTraceSPIDone,				// the SPI exchange completed
+	kTraceIRQ,				// the MAX lowered IRQ (INT2)
+	kTraceKeysRead,				// the keys were read, and IRQ is high again
+	kTraceKeysReadIRQLow			// the keys were read, but IRQ is still low
+	};
+
+
+/*	TraceEntry
+	An event, and the µs clock (modulo 65536) when it happened
+	
+	Consecutive entries are less than 65.536 ms apart (see TraceTick); so
+	the host can take the differences modulo 65536.
+*/
+typedef struct {
+	uint8_t		event;
+	uint16_t	time;
+	} TraceEntry;
+
+
+/*	kTraceLength
+	Entries in the ring buffer; an 8-bit index wraps around by itself
+*/
+enum { kTraceLength = 256 };
+
+
+/*	kTraceRequest
+	Vendor requests (bmRequestType Vendor, Device) to read the trace
+	
+	To read the trace, the host stops it; reads the entries, oldest first;
+	then starts it again.  tools/Timeline does, and renders them.
+*/
+enum {
+	kTraceRequestStop = 1,			// IN, 2 bytes: stop recording; return the index of the next entry, and whether the buffer has wrapped around
+	kTraceRequestRead,			// IN: the entries from the index in wValue up to the end of the buffer; at most 85 (255 bytes) per request
+	kTraceRequestStart			// no data: forget the entries, and start recording
+	};
+
+
+extern TraceEntry gTrace[kTraceLength];
+
+extern void Trace(uint8_t);
+extern void TraceStart(void);
+extern void TraceStop(uint8_t *);
+extern void TraceTick(void);
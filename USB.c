@@ -17,11 +17,42 @@
 
 #include <xc.h>
 
+#include "Counters.h"
+#include "Display.h"
+#include "Task.h"
+#include "Timer1.h"
 #include "USB.h"
 #include "USBEndpoint0.h"
 #include "USBEndpoint1.h"
 
 
+/*	Buffer Descriptor Table
+	
+	Laid out for ping-pong buffering on all endpoints except Endpoint 0
+	(UCFG.PPB = 3) [PIC §24.4.4]: Endpoint 1 has an even [0] and odd [1] buffer
+	descriptor in each direction, which the SIE uses alternately.
+	
+	Defined here only, rather than in USB.h: every file including the header
+	would otherwise define them again.  XC8 tolerates that for absolute
+	variables; but it's the one thing keeping these sources from compiling
+	unchanged against a register model on a development machine, where
+	__at() places nothing.
+*/
+volatile BufferDescriptor
+	ep0Out __at(BDT_ADDR + 0),
+	ep0In __at(BDT_ADDR + 4),
+	ep1Out[2] __at(BDT_ADDR + 8),
+	ep1In[2] __at(BDT_ADDR + 16);
+
+// buffer sizes have to agree with gDeviceDescriptor.maxPacketSize0
+// must be one of 8, 16, 32, or 64 [USB Table 9-8]
+volatile uint8_t
+	ep0OutBuffer[32] __at(BDT_ADDR + 24),
+	ep0InBuffer[32] __at(BDT_ADDR + 56),
+	ep1OutBuffer[2][64] __at(BDT_ADDR + 88),
+	ep1InBuffer[2][14] __at(BDT_ADDR + 216);
+
+
 
 /*	Error
 	Watch this compiler warning:
@@ -29,10 +60,18 @@
 	According to the compiler user's guide, the duplication happens
 		 "since it has been called from both main-line and interrupt code"
 	While this was happening, the a debugger line break didn't work.
+	
+	The LED only shows that there was an error; gCounters.errors says how many.
 */
 void Error()
 {
 LATDbits.LATD3 = 0;
+
+// may be called from the interrupt handler as well as main-line code
+const bool interrupts = INTCONbits.GIE;
+INTCONbits.GIE = 0;
+gCounters.errors++;
+INTCONbits.GIE = interrupts;
 }
 
 
@@ -45,7 +84,7 @@ void USBInitialize()
 UCFGbits.FSEN = 1;				// USB full speed
 UCFGbits.UPUEN = 1;				// internal pull-up resistor enabled
 UCFGbits.UTRDIS = 0;				// don't disable transceiver (default)
-UCFGbits.PPB = 0;				// disable 'ping-pong' (double) buffering (default)
+UCFGbits.PPB = 3;				// 'ping-pong' (double) buffering on all but Endpoint 0
 
 // ***** disable module and reset
 // UCON = 0;
@@ -55,6 +94,12 @@ UIEbits.URSTIE = 0;
 UIEbits.TRNIE = 1;				// enable USB Transaction interrupts
 UIEbits.IDLEIE = 1;				// enable USB Idle detection interrupts
 UIEbits.ACTVIE = 0;
+UEIE = 0b10011111;				// all USB error conditions (see Counters)
+UIEbits.UERRIE = 1;				// enable USB Error interrupts
+
+#if REPORT_TIMESTAMPS || DISPLAY_SYNC_FRAMES
+	UIEbits.SOFIE = 1;			// enable Start-of-Frame interrupts, for timestamps or display sync
+	#endif
 
 // reset USB device address *** needed?
 UADDR = 0;
@@ -71,12 +116,15 @@ EnableEndpoint0();
 do UCONbits.USBEN = 1; while (!UCONbits.USBEN);
 
 // enable USB peripheral interrupts
+IPR3bits.USBIP = 1;				// high priority
 PIE3bits.USBIE = 1;
 }
 
 
 /*	HandleUSBTransaction
 	USB transaction completed
+	
+	USTAT describes the transaction at the head of the FIFO until TRNIF is cleared
 */
 static void HandleUSBTransaction()
 {
@@ -98,13 +146,46 @@ switch (USTATbits.ENDP) {
 }
 
 
+/*	HandleUSBTransactions
+	Task handling all completed USB transactions
+	
+	The SIE NAKs further transactions on an endpoint until we've re-armed its
+	buffer descriptor; so it's safe for this to run outside interrupt context,
+	sometime after the transactions completed.  Likewise for SETUP, with PKTDIS.
+*/
+static void HandleUSBTransactions()
+{
+// while there are queued transactions
+/* Loop over the USTAT FIFO here; otherwise, if another transaction has already
+   completed, will reassert the interrupt within 6 instruction cycles.
+   Theoretically it's an opportunity to avoid triggering another interrupt. */
+while (UIRbits.TRNIF) {
+	HandleUSBTransaction();
+
+	// clear interrupt flag for this transaction
+	UIRbits.TRNIF = 0;
+	}
+
+// let the next transaction interrupt again
+/* If one completed since we last looked, that happens right away. */
+UIEbits.TRNIE = 1;
+}
+
+
 /*	USBInterruptService
 	Service USB interrupts
 */
 void USBInterruptService()
 {
-if (UIRbits.UERRIF)
-	Error();
+// USB error(s)?
+/* CRC errors and bus turnaround timeouts are expected now and again on a real
+   bus; the host retries the transaction.  So count rather than Error(). */
+if (UIEbits.UERRIE && UIRbits.UERRIF) {
+	gCounters.usbErrors++;
+	
+	// UERRIF clears with the error condition flags [PIC: USB Error Interrupt Status Register]
+	UEIR = 0;
+	}
 
 // idle?
 if (UIEbits.IDLEIE && UIRbits.IDLEIF) {
@@ -125,7 +206,7 @@ if (UIEbits.ACTVIE && UIRbits.ACTVIF) {
 	// disable activity detection interrupts
 	UIEbits.ACTVIE = 0;
 
-	// [PIC 24.5.1.1]
+	// [PIC §24.5.1.1]
 	do UIRbits.ACTVIF = 0; while (UIRbits.ACTVIF);
 	}
 
@@ -137,20 +218,28 @@ if (UIEbits.URSTIE && UIRbits.URSTIF) {
 	// *** flush existing transactions?
 	while (UIRbits.TRNIF) UIRbits.TRNIF = 0;
 
-	// [PIC 24.5.1] *** interrupt automatically clears UADDR
+	// [PIC §24.5.1] *** interrupt automatically clears UADDR
 
 	// I think this is where I should set up EP0?
 	UIRbits.URSTIF = 0;
 	}
 
-// while there are queued transactions
-/* Loop over the USTAT FIFO here; otherwise, if another transaction has already
-   completed, will reassert the interrupt within 6 instruction cycles.
-   Theoretically it's an opportunity to avoid triggering another interrupt. */
-while (UIRbits.TRNIF) {
-	HandleUSBTransaction();
+// start of frame?
+if (UIEbits.SOFIE && UIRbits.SOFIF) {
+	Timer1StartOfFrame();
+	
+	#if DISPLAY_SYNC_FRAMES
+		DisplayStartOfFrame();
+		#endif
+	
+	UIRbits.SOFIF = 0;
+	}
 
-	// clear interrupt flag for this transaction
-	UIRbits.TRNIF = 0;
+// transaction(s) completed?
+/* Leave them to main(); mask the interrupt until it has handled them all, so
+   we don't keep interrupting (and posting) until then. */
+if (UIEbits.TRNIE && UIRbits.TRNIF) {
+	UIEbits.TRNIE = 0;
+	TaskPost(kTaskFromHigh, HandleUSBTransactions);
 	}
 }
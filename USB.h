@@ -18,7 +18,7 @@
 
 
 /*	BDSTAT
-	Buffer descriptor status register [PIC 24.4.1]
+	Buffer descriptor status register [PIC §24.4.1]
 */
 typedef union {
 	uint8_t		i;
@@ -44,7 +44,7 @@ typedef union {
 
 
 /*	BufferDescriptor
-	Endpoint buffer descriptor [PIC 24.4]
+	Endpoint buffer descriptor [PIC §24.4]
 */
 typedef struct {
 	BDSTAT		STAT;
@@ -63,23 +63,23 @@ typedef struct {
 #define BDT_ADDR 0x400
 #endif
 
-volatile BufferDescriptor
-	ep0Out __at(BDT_ADDR + 0),		// buffer descriptor Endpoint 0 OUT
-	ep0In __at(BDT_ADDR + 4),		// buffer descriptor Endpoint 0 IN
-	ep1Out __at(BDT_ADDR + 8),
-	ep1In __at(BDT_ADDR + 12);
+/* Defined (at their absolute addresses in USB RAM) in USB.c; see there for
+   the layout. */
+extern volatile BufferDescriptor
+	ep0Out,					// buffer descriptor Endpoint 0 OUT
+	ep0In,					// buffer descriptor Endpoint 0 IN
+	ep1Out[2],				// buffer descriptors Endpoint 1 OUT even/odd
+	ep1In[2];				// buffer descriptors Endpoint 1 IN even/odd
 
-// buffer sizes have to agree with gDeviceDescriptor.maxPacketSize0
-// must be one of 8, 16, 32, or 64 [USB Table 9-8]
-volatile uint8_t
-	ep0OutBuffer[32] __at(BDT_ADDR + 16),
-	ep0InBuffer[32] __at(BDT_ADDR + 48),
-	ep1OutBuffer[5] __at(BDT_ADDR + 80),
-	ep1InBuffer[5] __at(BDT_ADDR + 85);
+extern volatile uint8_t
+	ep0OutBuffer[32],
+	ep0InBuffer[32],
+	ep1OutBuffer[2][64],			// kPanelReportLength
+	ep1InBuffer[2][14];			// kInputReportLength (at most)
 
 
 /*	USBSetup
-	Setup transaction data [USB 9.3]
+	Setup transaction data [USB §9.3]
 */
 typedef struct {
 	// bmRequestType
@@ -159,7 +159,7 @@ typedef enum {
 	kOtherSpeedConfiguration,
 	kInterfacePower,
 	
-	/* [HID 7.1] */
+	/* [HID §7.1] */
 	kHID = 0x21,
 	kHIDReport,
 	kHIDPhysical
@@ -189,7 +189,7 @@ typedef struct {
 
 
 /*	ConfigurationDescriptor
-	[USB 9.6.3]
+	[USB §9.6.3]
 */
 typedef struct {
 	uint8_t		length;
@@ -207,7 +207,7 @@ typedef struct {
 
 
 /*	InterfaceClass
-	Interface descriptor class [USB ]
+	Interface descriptor class [USB §]
 */
 typedef enum /* unsigned char */ {
 	kInterfaceClassReserved,
@@ -233,7 +233,7 @@ typedef enum /* unsigned char */ {
 
 
 /*	InterfaceDescriptor
-	[USB 9.6.5]
+	[USB §9.6.5]
 */
 typedef struct {
 	uint8_t		length;
@@ -250,7 +250,7 @@ typedef struct {
 
 
 /*	HIDClassDescriptor1
-	[USBHID 6.2.1]
+	[USBHID §6.2.1]
 */
 typedef struct {
 	uint8_t		length;
@@ -301,10 +301,10 @@ typedef struct {
 	Base class of all USB HID Report Descriptor Items
 */
 typedef struct {
-	// type [HID 6.2.2.2]
+	// type [HID §6.2.2.2]
 	enum { kMain, kGlobal, kLocal };
 
-	// [HID 6.2.2.4] Main Item Tags
+	// [HID §6.2.2.4] Main Item Tags
 	enum {
 		kInput = 8,
 		kOutput,
@@ -313,7 +313,7 @@ typedef struct {
 		kCollectionEnd
 		};
 	
-	// [HID 6.2.2.6] values for Collection Items
+	// [HID §6.2.2.6] values for Collection Items
 	enum {
 		kCollectionPhysical,
 		kCollectionApplication,
@@ -324,7 +324,7 @@ typedef struct {
 		kCollectionUsageModifier
 		};
 	
-	// [HID 6.2.2.7] Global Item Tags
+	// [HID §6.2.2.7] Global Item Tags
 	enum {
 		kUsageGlobal,
 		kLogicalMinimum,
@@ -340,7 +340,7 @@ typedef struct {
 		kPop
 		};
 	
-	// [HID 6.2.2.8] Local Item Tags
+	// [HID §6.2.2.8] Local Item Tags
 	enum {
 		kUsageLocal,
 		kUsageMinimum,
@@ -384,7 +384,7 @@ typedef struct {
 
 
 /*	ClassSetupRequest
-	[HID 7.2]
+	[HID §7.2]
 */
 typedef enum {
 	kGetReport = 1,
@@ -396,6 +396,16 @@ typedef enum {
 	} ClassSetupRequest;
 
 
+/*	ReportType
+	High byte of wValue in GetReport and SetReport [HID §7.2.1]
+*/
+typedef enum {
+	kReportInput = 1,
+	kReportOutput,
+	kReportFeature
+	} ReportType;
+
+
 extern void USBInitialize(void);
 extern void USBInterruptService(void);
 extern void Error(void);
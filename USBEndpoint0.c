@@ -16,6 +16,10 @@
 
 #include <xc.h>
 
+#include "Counters.h"
+#include "Profile.h"
+#include "Timer1.h"
+#include "Trace.h"
 #include "USB.h"
 #include "USBEndpoint1.h"
 
@@ -32,9 +36,9 @@ static const DeviceDescriptor gDeviceDescriptor = {
 	sizeof gDeviceDescriptor,
 	kDevice,
 	0x0200, // USB version 02.00
-	0x00, // [DCDHID 5.1] class type is not defined at the device descriptor but at the interface descriptor
-	0x00,				// subclass: should not be used [HID 5.1]
-	0x00,				// protocol: should not be used [HID 5.1]
+	0x00, // [DCDHID §5.1] class type is not defined at the device descriptor but at the interface descriptor
+	0x00,				// subclass: should not be used [HID §5.1]
+	0x00,				// protocol: should not be used [HID §5.1]
 	kEndpoint0MaximumPacketLength,	// maximum packet size for Endpoint 0
 	0xF055, // vendor ID *** (pseudo-officially like "FOSS")
 	0x1234, // product ID ***
@@ -57,6 +61,7 @@ static const struct {
 	HIDReportDescriptorItem8 usage;
 	HIDReportDescriptorItem8 beginCollectionApplication;
 	
+	HIDReportDescriptorItem8 reportIDValues;
 	HIDReportDescriptorItem8 logicalMinimumInput;
 	HIDReportDescriptorItem32 logicalMaximumInput;
 	HIDReportDescriptorItem8 reportCountInput;
@@ -68,6 +73,53 @@ static const struct {
 	HIDReportDescriptorItem8 usageOutput;
 	HIDReportDescriptorItem8 output;
 	
+	HIDReportDescriptorItem8 usageFeature;
+	HIDReportDescriptorItem8 feature;
+	
+	HIDReportDescriptorItem8 usagePageKeys;
+	HIDReportDescriptorItem8 usageMinimumKeys;
+	HIDReportDescriptorItem8 usageMaximumKeys;
+	HIDReportDescriptorItem8 logicalMaximumKeys;
+	HIDReportDescriptorItem8 reportCountKeys;
+	HIDReportDescriptorItem8 reportSizeKeys;
+	HIDReportDescriptorItem8 inputKeys;
+	
+	#if REPORT_TIMESTAMPS
+		HIDReportDescriptorItem16 usagePageTime;
+		HIDReportDescriptorItem16 logicalMaximumFrame;
+		HIDReportDescriptorItem8 reportCountTime;
+		HIDReportDescriptorItem8 reportSizeTime;
+		HIDReportDescriptorItem8 usageFrame;
+		HIDReportDescriptorItem8 inputFrame;
+		HIDReportDescriptorItem16 logicalMaximumSubframe;
+		HIDReportDescriptorItem8 usageSubframe;
+		HIDReportDescriptorItem8 inputSubframe;
+		#endif
+	
+	HIDReportDescriptorItem16 usagePagePanel;
+	HIDReportDescriptorItem8 reportIDPanel;
+	HIDReportDescriptorItem16 logicalMaximumPanel;
+	HIDReportDescriptorItem8 reportCountPanel;
+	HIDReportDescriptorItem8 reportSizePanel;
+	HIDReportDescriptorItem8 usagePanel;
+	HIDReportDescriptorItem8 outputPanel;
+	
+	HIDReportDescriptorItem8 reportIDCounters;
+	HIDReportDescriptorItem32 logicalMaximumCounters;
+	HIDReportDescriptorItem8 reportCountCounters;
+	HIDReportDescriptorItem8 reportSizeCounters;
+	HIDReportDescriptorItem8 usageCounters;
+	HIDReportDescriptorItem8 featureCounters;
+	
+	#if PROFILE
+		HIDReportDescriptorItem8 reportIDProfile;
+		HIDReportDescriptorItem16 logicalMaximumProfile;
+		HIDReportDescriptorItem8 reportCountProfile;
+		HIDReportDescriptorItem8 reportSizeProfile;
+		HIDReportDescriptorItem8 usageProfile;
+		HIDReportDescriptorItem8 featureProfile;
+		#endif
+	
 	HIDReportDescriptorItem0 endCollectionApplication;
 	} gReportDescriptor = {
 	{ { 2, kGlobal, kUsageGlobal }, 0xffa0 },			// Usage Page is high 16 bits of Usage ID
@@ -75,6 +127,7 @@ static const struct {
 	{ { 1, kLocal, kUsageLocal }, 0x01 },
 	{ { 1, kMain, kCollection }, kCollectionApplication },
 	
+	{ { 1, kGlobal, kReportID }, kReportIDValues },
 	{ { 1, kGlobal, kLogicalMinimum }, 0 },
 	{ { 3, kGlobal, kLogicalMaximum }, 999999 },
 	{ { 1, kGlobal, kReportCount }, 2 /* displays */ },
@@ -86,10 +139,83 @@ static const struct {
 	{ { 1, kLocal, kUsageLocal }, 0x22 },
 	{ { 1, kMain, kOutput }, 0b10100010 },
 	
+	// same values, for the host to read at will through GetReport [HID §7.2.1]
+	{ { 1, kLocal, kUsageLocal }, 0x23 },
+	{ { 1, kMain, kFeature }, 0b10100010 },
+	
+	// keys pressed, following the values in the Input report
+	/* Last, so that the Button usage page doesn't carry over into the items above */
+	{ { 1, kGlobal, kUsageGlobal }, 0x09 },			// Button page
+	{ { 1, kLocal, kUsageMinimum }, 1 },
+	{ { 1, kLocal, kUsageMaximum }, 32 },
+	{ { 1, kGlobal, kLogicalMaximum }, 1 },
+	{ { 1, kGlobal, kReportCount }, 32 /* keys */ },
+	{ { 1, kGlobal, kReportSize }, 1 /* bit */ },
+	{ { 1, kMain, kInput }, 0b00000010 },			// Data, Variable, Absolute
+	
+	#if REPORT_TIMESTAMPS
+		// when the event happened: frame number, and µs into the frame
+		{ { 2, kGlobal, kUsageGlobal }, 0xffa0 },
+		{ { 2, kGlobal, kLogicalMaximum }, 2047 },
+		{ { 1, kGlobal, kReportCount }, 1 },
+		{ { 1, kGlobal, kReportSize }, 16 /* bits */ },
+		{ { 1, kLocal, kUsageLocal }, 0x25 },
+		{ { 1, kMain, kInput }, 0b00000010 },		// Data, Variable, Absolute
+		{ { 2, kGlobal, kLogicalMaximum }, 999 },
+		{ { 1, kLocal, kUsageLocal }, 0x26 },
+		{ { 1, kMain, kInput }, 0b01000010 },		// Data, Variable, Absolute, Null State (0xFFFF: unknown)
+		#endif
+	
+	// panel update: record count and records, as bytes (see kPanelRecord)
+	{ { 2, kGlobal, kUsageGlobal }, 0xffa0 },
+	{ { 1, kGlobal, kReportID }, kReportIDPanel },
+	{ { 2, kGlobal, kLogicalMaximum }, 255 },
+	{ { 1, kGlobal, kReportCount }, kPanelReportLength - 1 /* bytes */ },
+	{ { 1, kGlobal, kReportSize }, 8 /* bits */ },
+	{ { 1, kLocal, kUsageLocal }, 0x24 },
+	{ { 1, kMain, kOutput }, 0b00000010 },			// Data, Variable, Absolute
+	
+	// event counters, for the host to read through GetReport (see Counters)
+	{ { 1, kGlobal, kReportID }, kReportIDCounters },
+	{ { 3, kGlobal, kLogicalMaximum }, 65535 },
+	{ { 1, kGlobal, kReportCount }, sizeof (Counters) / 2 },
+	{ { 1, kGlobal, kReportSize }, 16 /* bits */ },
+	{ { 1, kLocal, kUsageLocal }, 0x27 },
+	{ { 1, kMain, kFeature }, 0b00000010 },			// Data, Variable, Absolute
+	
+	#if PROFILE
+		// hot path statistics, as bytes (see ProfileStats)
+		{ { 1, kGlobal, kReportID }, kReportIDProfile },
+		{ { 2, kGlobal, kLogicalMaximum }, 255 },
+		{ { 1, kGlobal, kReportCount }, kProfileReportLength - 1 /* bytes */ },
+		{ { 1, kGlobal, kReportSize }, 8 /* bits */ },
+		{ { 1, kLocal, kUsageLocal }, 0x28 },
+		{ { 1, kMain, kFeature }, 0b00000010 },		// Data, Variable, Absolute
+		#endif
+	
 	{ { 0, kMain, kCollectionEnd } }
 	};
 
 
+/*	POLLING_INTERVAL
+	Latency profile: the interval at which the host polls the HID endpoints,
+	in frames (ms at full speed) [USB §9.6.6]
+	
+	Select at build time by defining POLLING_INTERVAL as 1, 10, or 100 in the
+	project's preprocessor macros.  The host won't see a control change any
+	sooner than this; but at shorter intervals it also spends more bus time
+	polling.  Reports are only offered when the values change (see SendReport);
+	so a short interval does not result in more reports.
+*/
+#if !defined(POLLING_INTERVAL)
+	#define POLLING_INTERVAL 10
+	#endif
+
+#if POLLING_INTERVAL != 1 && POLLING_INTERVAL != 10 && POLLING_INTERVAL != 100
+	#error POLLING_INTERVAL must be 1, 10, or 100
+	#endif
+
+
 /* Currently, our device operates in a way that has the behavior of a radio frequency
    panel: it swaps active/standby frequencies and allows them to be adjusted with
    controls.  It could be said that the 'source of truth' resides with our device.
@@ -100,7 +226,7 @@ static const struct {
 enum { kConfigurationRadioPanel = 1 };
 
 
-/* [HID 7.1]
+/* [HID §7.1]
 	When a GetDescriptor(Configuration) request is issued, it returns
 		the Configuration descriptor,
 		all Interface descriptors,
@@ -135,12 +261,12 @@ static const struct {
 		0, // alternate setting
 		2, // number of endpoints
 		kInterfaceClassHID,
-		0x00,				// subclass: not a Boot Device [HID 4.2]
-		0x00,				// protocol: not a Boot Device [HID 4.3]
+		0x00,				// subclass: not a Boot Device [HID §4.2]
+		0x00,				// protocol: not a Boot Device [HID §4.3]
 		0 // no string descriptor
 		},
 	
-	/* HID class descriptor [HID 6.2.1] */ {
+	/* HID class descriptor [HID §6.2.1] */ {
 		sizeof gConfigurationDescriptor.hid,
 		kHID,
 		0x0111,				// class specification version: 01.11
@@ -160,8 +286,8 @@ static const struct {
 			kNoSynchronization, // not an isochronous endpoint
 			kData, // usage
 			0, // reserved
-			5,
-			100 /* polling interval *** */
+			kPanelReportLength,
+			POLLING_INTERVAL
 			},
 		
 		/* [1] */ {
@@ -174,8 +300,8 @@ static const struct {
 			kNoSynchronization, // not an isochronous endpoint
 			kData,
 			0,
-			5,
-			100 /* polling interval *** */
+			kInputReportLength,
+			POLLING_INTERVAL
 			}
 		}
 	};
@@ -242,10 +368,13 @@ ep0In.STAT.UOWN = 1;				// must be separate instruction
 /*	gEndpoint0OUT
 	If Data is not NULL, then we are in the Data or Status Stage of a Control Write Transfer
 	If DataL is not zero, then we are in the Data
+	Complete is called with the received data at the end of the Data Stage;
+	it gives whether it took the data (otherwise the Status Stage STALLs)
 */
-static char *gEndpoint0OUTData;
-static char gEndpoint0OUTDataL;
+static volatile uint8_t *gEndpoint0OUTData;
+static uint8_t gEndpoint0OUTDataL;
 static bool gEndpoint0OUTToggle;
+static bool (*gEndpoint0OUTComplete)(const volatile uint8_t *);
 
 
 static const char *gEndpoint0INData;
@@ -260,7 +389,7 @@ static bool gEndpoint0INToggle;
 	
 	1)	as a DATA0 Setup Stage Transaction;
 		this can happen at any time, even if a Control Read or Write is
-		still in progress [USB 8.5.3]
+		still in progress [USB §8.5.3]
 	2)	as a DATA0/1 during the Data Stage of a Control Write;
 	3)	as a DATA1 the Status Stage of a Control Read
 */
@@ -418,7 +547,7 @@ switch (index) {
 
 /*	HandleGetDescriptor
 	
-	[USB 9.4.3] 
+	[USB §9.4.3] 
 		If the descriptor is longer than the wLength field,
 		only the initial bytes of the descriptor are returned. If the descriptor is shorter than the wLength field, the
 		device indicates the end of the control transfer by sending a short packet when further data is requested. A
@@ -449,12 +578,12 @@ switch (setup->getDescriptor.type) {
 	
 	// device qualifier?
 	case kDeviceQualifier:
-		// [USB 9.6.2] high-speed capable devices only
+		// [USB §9.6.2] high-speed capable devices only
 		// stall endpoint to signal inability to handle
 		ArmEndpoint0INStall();
 		break;
 	
-	// HID class Report Descriptor [HID 6.2.2]
+	// HID class Report Descriptor [HID §6.2.2]
 	case kHIDReport:
 		gEndpoint0INData = (char*) &gReportDescriptor;
 		gEndpoint0INDataL = sizeof gReportDescriptor;
@@ -477,7 +606,7 @@ if (gEndpoint0INData)
 
 /*	gAddressPending
 	If nonzero, received the SETUP of the SetAddress
-	Zero indicates no SetAddress has been received ([USB 9.4.6] states that
+	Zero indicates no SetAddress has been received ([USB §9.4.6] states that
 	"a device response to SetAddress with a value of 0 is undefined", suggesting
 	that 0 is not a valid device address).
 */
@@ -485,7 +614,7 @@ static uint8_t gPendingAddress;
 
 
 /*	HandleSetAddress
-	[USB 9.4.6]
+	[USB §9.4.6]
 */
 static void HandleSetAddress(
 	const USBSetup *const setup
@@ -502,18 +631,18 @@ gPendingAddress = (uint8_t) setup->wValue;
 
 
 /*	HandleSetConfiguration
-	[USB 9.4.7]
+	[USB §9.4.7]
 */
 static void HandleSetConfiguration(
 	const USBSetup *const setup
 	)
 {
-/* [USB 9.4.7] If wIndex, wLength, or the upper byte of wValue is non-zero, then
+/* [USB §9.4.7] If wIndex, wLength, or the upper byte of wValue is non-zero, then
    the behavior of this request is not specified. */
 
 // which configuration to apply?
 switch (setup->setConfiguration.index) {
-	/* [USB 9.4.7] zero places the device in its ?address state? */
+	/* [USB §9.4.7] zero places the device in its ?address state? */
 	case 0:
 		// disable data endpoints
 		DisableEndpoint1();
@@ -567,12 +696,33 @@ enum {
 	};
 
 
+/*	ClearFeatureEndpoint
+	[USB §9.4.1]
+*/
 static void ClearFeatureEndpoint(
 	const USBSetup *const setup
 	)
 {
 switch (setup->wValue) {
 	case kFeatureEndpointHalt:
+		// which endpoint (and direction)? [USB Figure 9-2]
+		switch (setup->wIndex) {
+			// Endpoint 0 never halts; a STALL only lasts until the next SETUP
+			case 0x00:
+			case 0x80:
+				break;
+			
+			case 0x01:
+				ClearEndpoint1Halt(false);
+				break;
+			
+			case 0x81:
+				ClearEndpoint1Halt(true);
+				break;
+			
+			default:
+				Error();
+			}
 		break;
 	
 	default:
@@ -597,55 +747,194 @@ switch (setup->bRequest) {
 	default:
 		Error();
 	}
+
+// 'arm' Endpoint 0 IN in anticipation of Status Stage Transaction
+ArmEndpoint0INStatus();
 }
 
 
 /*	HandleHIDGetReport
- 
+	[HID §7.2.1]
+	
+	Lets the host read the current values through the control pipe, without
+	waiting for them to change (e.g., after it has reconnected).  The Feature
+	report has the same values as the Input report, without the keys.
+	
+	The counters (and with PROFILE, the statistics) are only a Feature
+	report; reading them doesn't involve Endpoint 1.
 */
 static void HandleHIDGetReport(
 	const USBSetup *const setup
 	)
 {
-Error();
+/* This only has to last until ArmEndpoint0IN has copied it into USB memory.
+   As long as the longest report; a union rather than comparing the lengths,
+   which are of different enumerations. */
+static union {
+	uint8_t		input[kInputReportLength];
+	uint8_t		counters[kCountersReportLength];
+	#if PROFILE
+		uint8_t		profile[kProfileReportLength];
+		#endif
+	} reports;
+uint8_t *const report = (uint8_t*) &reports;
+
+// counters?
+if (setup->valueLow == kReportIDCounters && setup->valueHigh == kReportFeature) {
+	GetCountersReport(report);
+	gEndpoint0INData = (char*) report;
+	gEndpoint0INDataL = kCountersReportLength;
+	return;
+	}
+
+#if PROFILE
+	// statistics?
+	if (setup->valueLow == kReportIDProfile && setup->valueHigh == kReportFeature) {
+		GetProfileReport(report);
+		gEndpoint0INData = (char*) report;
+		gEndpoint0INDataL = kProfileReportLength;
+		return;
+		}
+	#endif
+
+// otherwise only the values can be read
+if (setup->valueLow != kReportIDValues) { Error(); return; }
+
+// on report type
+switch (setup->valueHigh) {
+	case kReportInput:
+		GetInputReport(report);
+		gEndpoint0INData = (char*) report;
+		gEndpoint0INDataL = kInputReportLength;
+		break;
+	
+	case kReportFeature:
+		GetValuesReport(report);
+		gEndpoint0INData = (char*) report;
+		gEndpoint0INDataL = kValuesReportLength;
+		break;
+	
+	default:
+		Error();
+	}
+}
+
+
+/*	ReceiveValuesReport
+	The Data Stage of SetReport completed: count the report, and display it
+	
+	Only now; the host may yet send too little or too much data for it.  Nor
+	if the data doesn't start with the report ID that the SETUP announced.
+*/
+static bool ReceiveValuesReport(
+	const volatile uint8_t *report
+	)
+{
+if (report[0] != kReportIDValues) return false;
+
+gCounters.reportsReceived++;
+PutValuesReport(report);
+return true;
 }
 
 
 /*	HandleHIDSetReport
-	[HID 7.2.2]
+	[HID §7.2.2]
+	
+	For hosts that send reports through the control pipe rather than the
+	interrupt OUT pipe.  Output and Feature reports have the same content.
+	
+	Only the values report: a panel report doesn't fit the single Endpoint 0
+	packet that HandleEndpoint0OUT requires; it has to go through Endpoint 1.
+	And with PROFILE, the statistics report ID alone, to reset them.
 */
-static void HandleHIDSetReport(
+static bool HandleHIDSetReport(
 	const USBSetup *const setup
 	)
 {
+#if PROFILE
+	// reset the statistics?
+	if (setup->valueLow == kReportIDProfile && setup->valueHigh == kReportFeature && setup->wLength == 1) {
+		gEndpoint0OUTData = ep0OutBuffer;
+		gEndpoint0OUTDataL = 1;
+		gEndpoint0OUTComplete = PutProfileReport;
+		return true;
+		}
+	#endif
+
+// the values report, of its one length
+if (setup->valueLow != kReportIDValues || setup->wLength != kValuesReportLength) { Error(); return false; }
+
 // on report type
 switch (setup->valueHigh) {
-	case 2:
-		// prepare to receive the output Report
+	case kReportOutput:
+	case kReportFeature:
+		// prepare to receive the Report, and then display it
 		gEndpoint0OUTData = ep0OutBuffer;
-		gEndpoint0OUTDataL = sizeof ep0OutBuffer;
-		// ***** set the continuation or something
-		break;
+		gEndpoint0OUTDataL = kValuesReportLength;
+		gEndpoint0OUTComplete = ReceiveValuesReport;
+		return true;
 	
 	default:
 		Error();
+		return false;
 	}
 }
 
 
+/*	IdleReport
+	Whether the report ID in an idle request is one that the idle rate
+	applies to [HID §7.2.4]: 0 (all reports), or that of the one Input report
+	
+	Either means the Endpoint 1 IN idle rate.  Another report ID is a request
+	the host is entitled to make, and gets a STALL; but it's not a fault of
+	ours, so not an Error().
+*/
+static bool IdleReport(
+	const USBSetup *const setup
+	)
+{
+return setup->valueLow == 0 || setup->valueLow == kReportIDValues;
+}
+
+
+/*	HandleHIDGetIdle
+	Report the current idle rate [HID §7.2.4]
+*/
+static void HandleHIDGetIdle(
+	const USBSetup *const setup
+	)
+{
+if (!IdleReport(setup)) return;
+
+/* This only has to last until ArmEndpoint0IN has copied it into USB memory */
+static uint8_t idleRate;
+idleRate = GetIdleRate();
+
+gEndpoint0INData = (char*) &idleRate;
+gEndpoint0INDataL = sizeof idleRate;
+}
+
+
 /*	HandleHIDSetIdle
-	Limit reporting frequency [HID 7.2.4]
+	Limit reporting frequency [HID §7.2.4]
+	
+	The upper byte of wValue is the duration, in 4 ms units; the lower byte
+	the report ID (see IdleReport)
 */
-static void HandleHIDSetIdle(
+static bool HandleHIDSetIdle(
 	const USBSetup *const setup
 	)
 {
-// ***** implement
+if (!IdleReport(setup)) return false;
+
+SetIdleRate(setup->valueHigh);
+return true;
 }
 
 
 /*	HandleEndpoint0ToHostClassInterface
-	Class-specific requests (IN, to host) [HID 7.2]
+	Class-specific requests (IN, to host) [HID §7.2]
 */
 static void HandleEndpoint0ToHostClassInterface(
 	const USBSetup *const setup
@@ -656,44 +945,69 @@ switch (setup->bRequest) {
 		HandleHIDGetReport(setup);
 		break;
 	
+	case kGetIdle:
+		HandleHIDGetIdle(setup);
+		break;
+	
 	default:
 		Error();
 	}
 
-// 'arm' Endpoint 0 IN in anticipation of Status Stage Transaction
-/* *** Note that we can only do this because we know that all the 'to-device'/Control Write transfers
-   that we support right now do not send data. */
-ArmEndpoint0INStatus();
+// need to send data on Control Read Transfer?
+if (gEndpoint0INData) {
+	// don't send more than requested length
+	if (gEndpoint0INDataL > setup->wLength)
+		gEndpoint0INDataL = (uint8_t) setup->wLength;
+	
+	gEndpoint0INToggle = 1;		// Data 1 packet expected first
+	ArmEndpoint0IN();
+	}
+
+// request not supported
+else
+	ArmEndpoint0INStall();
 }
 
 
 /*	HandleEndpoint0ToDeviceClassInterface
-	Class-specific requests (OUT, to device) [HID 7.2]
+	Class-specific requests (OUT, to device) [HID §7.2]
+	
+	A request we don't support gets a STALL for its Status Stage [USB §8.5.3.4];
+	a zero-length packet there would tell the host it succeeded.
 */
 static void HandleEndpoint0ToDeviceClassInterface(
 	const USBSetup *const setup
 	)
 {
+bool supported;
+
 switch (setup->bRequest) {
 	case kSetReport:
-		HandleHIDSetReport(setup);
+		supported = HandleHIDSetReport(setup);
 		break;
 	
 	case kSetIdle:
-		HandleHIDSetIdle(setup);
+		supported = HandleHIDSetIdle(setup);
 		break;
 	
 	default:
 		Error();
+		supported = false;
 	}
 
-// 'arm' Endpoint 0 IN in anticipation of eventual Status Stage Transaction
-ArmEndpoint0INStatus();
+if (!supported)
+	ArmEndpoint0INStall();
 
 // expect to receive data on Control Write Transfer?
-if (gEndpoint0OUTData)
+/* The Status Stage is armed when the data has been received; so that it
+   can still be a STALL if the data is wrong. */
+else if (gEndpoint0OUTData)
 	// DATA1 expected first
 	gEndpoint0OUTToggle = 1;
+
+else
+	// 'arm' Endpoint 0 IN in anticipation of Status Stage Transaction
+	ArmEndpoint0INStatus();
 }
 
 
@@ -740,6 +1054,81 @@ if (gEndpoint0INData) {
 }
 
 
+#if TRACE
+/*	HandleEndpoint0ToHostVendorDevice
+	Vendor requests (IN, to host): read the trace (see kTraceRequest)
+*/
+static void HandleEndpoint0ToHostVendorDevice(
+	const USBSetup *const setup
+	)
+{
+switch (setup->bRequest) {
+	case kTraceRequestStop: {
+		/* This only has to last until ArmEndpoint0IN has copied it into USB memory */
+		static uint8_t status[2];
+		TraceStop(status);
+		
+		gEndpoint0INData = (char*) status;
+		gEndpoint0INDataL = sizeof status;
+		}
+		break;
+	
+	case kTraceRequestRead: {
+		if (setup->wValue >= kTraceLength) { Error(); break; }
+		
+		// whole entries, up to the end of the buffer
+		/* The entries stay put while the trace is stopped; they are sent from
+		   where they are. */
+		const uint16_t entries = kTraceLength - setup->wValue;
+		gEndpoint0INData = (char*) &gTrace[setup->wValue];
+		gEndpoint0INDataL = entries < 255 / sizeof (TraceEntry) ?
+			(uint8_t) (entries * sizeof (TraceEntry)) :
+			255 / sizeof (TraceEntry) * sizeof (TraceEntry);
+		}
+		break;
+	
+	default:
+		Error();
+	}
+
+// need to send data on Control Read Transfer?
+if (gEndpoint0INData) {
+	// don't send more than requested length
+	if (gEndpoint0INDataL > setup->wLength)
+		gEndpoint0INDataL = (uint8_t) setup->wLength;
+	
+	gEndpoint0INToggle = 1;		// Data 1 packet expected first
+	ArmEndpoint0IN();
+	}
+
+// request not supported
+else
+	ArmEndpoint0INStall();
+}
+
+
+/*	HandleEndpoint0ToDeviceVendorDevice
+	Vendor requests (OUT, to device): restart the trace (see kTraceRequest)
+*/
+static void HandleEndpoint0ToDeviceVendorDevice(
+	const USBSetup *const setup
+	)
+{
+switch (setup->bRequest) {
+	case kTraceRequestStart:
+		TraceStart();
+		break;
+	
+	default:
+		Error();
+	}
+
+// 'arm' Endpoint 0 IN in anticipation of eventual Status Stage Transaction
+ArmEndpoint0INStatus();
+}
+	#endif
+
+
 /*	HandleEndpoint0SETUP
 	Handle SETUP transactions on Endpoint 0
 */
@@ -782,12 +1171,24 @@ switch (setup->bmRequestType) {
 		HandleEndpoint0ToHostClassInterface(setup);
 		break;
 	
+	#if TRACE
+		// host-to-device, Vendor, Device?
+		case 0b01000000:
+			HandleEndpoint0ToDeviceVendorDevice(setup);
+			break;
+		
+		// device-to-host, Vendor, Device?
+		case 0b11000000:
+			HandleEndpoint0ToHostVendorDevice(setup);
+			break;
+		#endif
+	
 	default:
 		Error();
 		break;
 	}
 
-// resume processing packets again after SETUP ([PIC 24.2.1] "to allow setup processing")
+// resume processing packets again after SETUP ([PIC §24.2.1] "to allow setup processing")
 UCONbits.PKTDIS = 0;
 }
 
@@ -800,7 +1201,7 @@ UCONbits.PKTDIS = 0;
 		received data as part the Data Stage of a Control Write, or we
 		completed the Status Stage of a Control Read
 		
-	As the handshake of a Control Read transfer [USB 8.5.3.1]
+	As the handshake of a Control Read transfer [USB §8.5.3.1]
 		The host may only send a zero-length data packet in this phase
 		but the function may accept any length packet as a valid status inquiry.
 */
@@ -809,18 +1210,57 @@ static void HandleEndpoint0OUT()
 // Control Write Transfer? (Data Stage)
 if (gEndpoint0OUTData) {
 	/* Will try handling Control Writes *without* copying to a destination buffer;
-	   if I like this, do the same with Control Reads (which currently *do* copy). */
-	// ***** update receive pointers
-	if (ep0Out.CNT == kEndpoint0MaximumPacketLength) {
-		gEndpoint0OUTToggle = !gEndpoint0OUTToggle;
+	   if I like this, do the same with Control Reads (which currently *do* copy).
+	   The data is handed to the recipient where the SIE put it, in USB memory.
+	   That means it has to arrive in a single packet: the buffer is reused for
+	   the next one (which may also be a SETUP). */
+	const uint8_t received = ep0Out.CNT;
+	
+	// more than the host announced in wLength?
+	if (received > gEndpoint0OUTDataL) {
+		Error();
+		
+		// refuse the Status Stage; there is no more to this transfer
+		gEndpoint0OUTData = NULL;
+		ArmEndpoint0INStall();
+		return;
 		}
 	
-	gEndpoint0INData += ep0Out.CNT;
-	gEndpoint0OUTDataL -= ep0Out.CNT;
+	// update receive pointers
+	gEndpoint0OUTToggle = !gEndpoint0OUTToggle;
+	gEndpoint0OUTData += received;
+	gEndpoint0OUTDataL -= received;
+	
+	// all data received?
+	/* [USB §8.5.3.2] The Data Stage ends when the host has sent wLength
+	   bytes; or earlier with a short packet.  Only the former is valid for
+	   a report. */
+	if (gEndpoint0OUTDataL == 0) {
+		// hand over the data, before ArmEndpoint0OUT lets the SIE overwrite it
+		if (!(*gEndpoint0OUTComplete)(ep0OutBuffer)) {
+			Error();
+			
+			// refuse the Status Stage
+			gEndpoint0OUTData = NULL;
+			ArmEndpoint0INStall();
+			}
+		
+		// 'arm' Endpoint 0 IN for the Status Stage; gEndpoint0OUTData
+		// remains set until it completes
+		else
+			ArmEndpoint0INStatus();
+		}
+	
+	// short packet before wLength?
+	else if (received < kEndpoint0MaximumPacketLength) {
+		Error();
+		
+		gEndpoint0OUTData = NULL;
+		ArmEndpoint0INStall();
+		}
 	}
 
-// long packet; expect to receive more data on Control Write Transfer
-// [***] where is it documented that we will receive ZLP in case it aligns?
+// Status Stage of a Control Read
 else {
 	// ***** handle
 	
@@ -857,7 +1297,7 @@ if (gPendingAddress) {
 // Status Stage of Control Write Transfer?
 if (gEndpoint0OUTData)
 	// have already armed Endpoint 0 OUT for Setup Stage of new Control Transfer
-	;
+	gEndpoint0OUTData = NULL;
 
 // must have been in response to a Control Read Transfer
 else {
@@ -893,8 +1333,15 @@ if (USTATbits.DIR == 0)
 			break;
 
 		// SETUP? (first Transaction of Control Transfer)
-		case 0b1101:
+		case 0b1101: {
+			#if PROFILE
+				const uint16_t start = Timer1Read();
+				#endif
 			HandleEndpoint0SETUP();
+			#if PROFILE
+				ProfileRecord(kProfileEndpoint0SETUP, start);
+				#endif
+			}
 			break;
 
 		default:
@@ -913,5 +1360,9 @@ else
 		}
 
 // arm Endpoint 0 OUT for the Status Stage of the Control Read, or an early SETUP
-ArmEndpoint0OUT();
+/* Unless it still is: after an IN transaction, the SIE has had it since the
+   previous OUT or SETUP; and taking it back could lose a SETUP arriving
+   meanwhile. */
+if (!ep0Out.STAT.UOWN)
+	ArmEndpoint0OUT();
 }
\ No newline at end of file
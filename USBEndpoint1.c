@@ -12,51 +12,152 @@
 		[PIC] Microchip PIC18(L)F2X/45K50 Data Sheet
 */
 
+#include <stdbool.h>
+
 #include <xc.h>
 
+#include "Counters.h"
 #include "Display.h"
 #include "SPI.h"
+#include "Timer.h"
+#include "Timer1.h"
+#include "Trace.h"
 #include "USB.h"
 #include "USBEndpoint1.h"
 
 
 /*	gToggleIN
 	
-	[USB 8.5.4] "interrupt endpoint is initialized to the DATA0 PID by any configuration event"
+	[USB §8.5.4] "interrupt endpoint is initialized to the DATA0 PID by any configuration event"
+	
+	With ping-pong buffering, both IN buffer descriptors may be armed at the same
+	time; so the toggle is assigned when a buffer descriptor is armed rather than
+	when its transaction completes.
 */
 static char gToggleIN;
 
 
-static void ArmEndpoint1OUT()
+/*	gSent
+	Whether a report was offered to the host since the endpoint was configured
+*/
+static bool gSent;
+
+
+/*	gReportValue
+	The latest values given to SendReport; and whether the host still has to
+	be sent a report with them
+	
+	Values are state: only the latest matter.  While both IN buffer
+	descriptors are owned by the SIE, a newer pair simply replaces one that
+	is still waiting.
+*/
+static __uint24 gReportValue0, gReportValue1;
+static Timestamp gReportValuesTime;
+static bool gReportValuesPending;
+
+
+/*	gKeysQueue
+	Key presses waiting for an IN buffer descriptor, oldest first
+	
+	Key presses are events: each bitmap gets its own report, in order (with
+	the values current when it goes out).  The length must be a power of two.
+*/
+enum { kKeysQueueLength = 4 };
+
+static uint32_t gKeysQueue[kKeysQueueLength];
+static Timestamp gKeysQueueTimes[kKeysQueueLength];
+static uint8_t gKeysQueueHead, gKeysQueueN;
+
+
+/*	gIdleRate
+	[HID §7.2.4] Duration, in 4 ms units, after which the current values are
+	reported again even though nothing changed; zero (the default) means only
+	changes are reported
+*/
+static uint8_t gIdleRate;
+
+
+/*	gIdleTimer
+	Runs while the idle rate is not zero; elapses every idle period
+*/
+static Timer gIdleTimer;
+
+
+static void IdleElapsed(void);
+
+
+/*	gPingPongIN
+	Which Endpoint 1 IN buffer descriptor (even or odd) is to be armed next
+	
+	The SIE alternates between the two [PIC §24.4.4]; arming them in the same
+	order keeps us in step.
+*/
+static uint8_t gPingPongIN;
+
+
+/*	ArmEndpoint1OUT
+	Hand the given (even or odd) Endpoint 1 OUT buffer descriptor to the SIE
+*/
+static void ArmEndpoint1OUT(
+	uint8_t		pingPong
+	)
 {
-if (ep1Out.STAT.UOWN) Error();
+volatile BufferDescriptor *const bd = &ep1Out[pingPong];
+
+if (bd->STAT.UOWN) Error();
 
 // data to expect in the next OUT transaction
-ep1Out.ADR = ep1OutBuffer;
-ep1Out.CNT = sizeof ep1OutBuffer;
+bd->ADR = ep1OutBuffer[pingPong];
+bd->CNT = sizeof ep1OutBuffer[pingPong];
 
-ep1Out.STAT.i = 0;
+bd->STAT.i = 0;
+
+// expect DATA0 in the even, DATA1 in the odd buffer descriptor
+/* [USB §8.6.4] A host that didn't see our ACK sends the same packet again,
+   with the same toggle.  With synchronization enabled, the SIE ACKs it but
+   leaves the buffer descriptor alone [PIC §24.4.1]; so the SIE doesn't
+   move on to the other buffer descriptor either, and even/odd stays in step
+   with DATA0/DATA1.  Without it, we'd handle the report twice. */
+bd->STAT.DTS = pingPong;
+bd->STAT.DTSEN = 1;
 
 // 'arm' Endpoint 1 OUT in anticipation of next Data Stage Transaction
-ep1Out.STAT.UOWN = 1;				// must be separate instruction
+bd->STAT.UOWN = 1;				// must be separate instruction
 }
 
 
+/*	ArmEndpoint1IN
+	Hand the next Endpoint 1 IN buffer descriptor, already filled, to the SIE
+*/
 static void ArmEndpoint1IN()
 {
-if (ep1In.STAT.UOWN) Error();
+volatile BufferDescriptor *const bd = &ep1In[gPingPongIN];
+
+if (bd->STAT.UOWN) Error();
 
 // data to send in the next IN transaction
 /* I *think* that if you send more data back than the host expects (even from the HID descriptor?!)
    then the transaction fails (possibly stalls) and you never get the TRNIF. */
-ep1In.ADR = ep1InBuffer;
-ep1In.CNT = sizeof ep1InBuffer;
-ep1In.STAT.i = 0;
-ep1In.STAT.DTS = gToggleIN;
-ep1In.STAT.DTSEN = 1;
+bd->ADR = ep1InBuffer[gPingPongIN];
+bd->CNT = kInputReportLength;
+bd->STAT.i = 0;
+bd->STAT.DTS = gToggleIN;
+bd->STAT.DTSEN = 1;
 
 // 'arm' Endpoint 1 IN in anticipation of next Data Stage Transaction
-ep1In.STAT.UOWN = 1;				// must be separate instruction
+bd->STAT.UOWN = 1;				// must be separate instruction
+
+#if TRACE
+	Trace(kTraceINArmed);
+	#endif
+
+// prepare the data toggle for a next IN transaction
+/* [USB §8.5.4
+	When an endpoint is using the interrupt transfer mechanism
+	for actual interrupt data, the data toggle protocol must be followed. "
+*/
+gToggleIN = !gToggleIN;
+gPingPongIN ^= 1;
 }
 
 
@@ -65,13 +166,30 @@ ep1In.STAT.UOWN = 1;				// must be separate instruction
 */
 void EnableEndpoint1()
 {
-ep1Out.STAT.i = 0;
-ep1In.STAT.i = 0;
+ep1Out[0].STAT.i = 0;
+ep1Out[1].STAT.i = 0;
+ep1In[0].STAT.i = 0;
+ep1In[1].STAT.i = 0;
+
+// start over with the even buffer descriptors, and with DATA0
+UCONbits.PPBRST = 1;
+gPingPongIN = 0;
+gToggleIN = 0;
+UCONbits.PPBRST = 0;
 
-// be prepared for host to send report
-ArmEndpoint1OUT();
+// no report offered yet, or waiting
+gSent = false;
+gReportValuesPending = false;
+gKeysQueueN = 0;
 
-// do not arm IN until we cause a change in values *** respect SetIdle though
+// only report changes, until the host asks otherwise
+SetIdleRate(0);
+
+// be prepared for host to send reports; the second while handling the first
+ArmEndpoint1OUT(0);
+ArmEndpoint1OUT(1);
+
+// do not arm IN until we cause a change in values, or the idle period elapses
 
 UEP1bits.EPHSHK = 1;				// enable USB handshake
 UEP1bits.EPCONDIS = 1;				// disable Control
@@ -83,6 +201,67 @@ DisplayInitialize();
 }
 
 
+/*	ClearEndpoint1Halt
+	[USB §9.4.5] The host cleared the Halt feature of Endpoint 1 OUT, or IN;
+	which resets the data toggle of that direction to DATA0
+	
+	The host's next OUT is then DATA0; so the SIE has to start over with the
+	even OUT buffer descriptor (see ArmEndpoint1OUT), or it would ACK and drop
+	that packet.  PPBRST does that, but for both directions at once [PIC:
+	Ping-Pong Buffering]: the reports the SIE still has in the IN buffer
+	descriptors are taken back, and armed again starting from the even one,
+	in the same order and (unless it was the IN direction that was cleared)
+	with the same toggles.
+*/
+void ClearEndpoint1Halt(
+	bool		in
+	)
+{
+// keep the SIE off Endpoint 1 while we take back its buffer descriptors
+const uint8_t endpoint = UEP1;
+UEP1 = 0;
+
+// reports not collected yet, oldest first
+/* When both are armed, the oldest is the one that would be armed next. */
+uint8_t reports[2][kInputReportLength];
+const uint8_t reportsN = ep1In[0].STAT.UOWN + ep1In[1].STAT.UOWN;
+
+uint8_t pingPong = reportsN == 2 ? gPingPongIN : gPingPongIN ^ 1;
+for (uint8_t r = 0; r < reportsN; r++, pingPong ^= 1)
+	for (uint8_t b = 0; b < kInputReportLength; b++)
+		reports[r][b] = ep1InBuffer[pingPong][b];
+
+// the toggle of the oldest; each armed buffer descriptor flipped it once
+if (in)
+	gToggleIN = 0;
+
+else if (reportsN == 1)
+	gToggleIN = !gToggleIN;
+
+ep1Out[0].STAT.i = 0;
+ep1Out[1].STAT.i = 0;
+ep1In[0].STAT.i = 0;
+ep1In[1].STAT.i = 0;
+
+// start over with the even buffer descriptors
+UCONbits.PPBRST = 1;
+gPingPongIN = 0;
+UCONbits.PPBRST = 0;
+
+ArmEndpoint1OUT(0);
+ArmEndpoint1OUT(1);
+
+for (uint8_t r = 0; r < reportsN; r++) {
+	for (uint8_t b = 0; b < kInputReportLength; b++)
+		ep1InBuffer[gPingPongIN][b] = reports[r][b];
+	
+	ArmEndpoint1IN();
+	}
+
+UEP1 = endpoint;
+}
+
+
 /*	DisableEndpoint1
 	Disable the HID data endpoint
 */
@@ -91,11 +270,16 @@ void DisableEndpoint1()
 // disable display
 DisplayTerminate();
 
+// stop repeating reports
+TimerStop(&gIdleTimer);
+
 // disarm Endpoint 1 OUT
-ep1Out.STAT.UOWN = 0;
+ep1Out[0].STAT.UOWN = 0;
+ep1Out[1].STAT.UOWN = 0;
 
 // disarm Endpoint 1 IN
-ep1In.STAT.UOWN = 0;
+ep1In[0].STAT.UOWN = 0;
+ep1In[1].STAT.UOWN = 0;
 
 // disable Endpoint 1 transactions *****
 UEP1 = 0;
@@ -111,74 +295,408 @@ typedef union {
 		uint16_t	i1;
 		__uint24	v1;
 		};
-	char		b[5];
+	char		b[kValuesLength];
 	} Report;
 
 
+/*	PackValues
+	Pack the two 20-bit values, as in a report
+*/
+static void PackValues(
+	volatile uint8_t *buffer,
+	__uint24	value0,
+	__uint24	value1
+	)
+{
+// *** assembly
+Report r;
+r.v0 = value0;
+r.v1 = value1 << 4;
+r.b[2] = (value0 >> 16) | ((value1 & 0x0F) << 4);
+
+buffer[0] = r.b[0];
+buffer[1] = r.b[1];
+buffer[2] = r.b[2];
+buffer[3] = r.b[3];
+buffer[4] = r.b[4];
+}
+
 
-/*	HandleEndpoint1OUT
-	Receive HID report for display
+/*	PutValues
+	Display the two 20-bit values packed as in a report
 */
-static void HandleEndpoint1OUT()
+static void PutValues(
+	const volatile uint8_t *values
+	)
 {
 // copy the HID report (seems to be more code-efficient than pointer-aliasing)
 Report r;
-r.b[0] = ep1OutBuffer[0];
-r.b[1] = ep1OutBuffer[1];
-r.b[2] = ep1OutBuffer[2];
-r.b[3] = ep1OutBuffer[3];
-r.b[4] = ep1OutBuffer[4];
+r.b[0] = values[0];
+r.b[1] = values[1];
+r.b[2] = values[2];
+r.b[3] = values[3];
+r.b[4] = values[4];
 
 // extract the 20-bit values *** assembly
 __uint24 v0 = 0, v1 = 0;
 v0 = r.v0 & 0x0FFFFF;
-v1 = r.v1 >> 4;
+/* Masked as well: where __uint24 is wider (the host-side tests), v1 also
+   takes in the byte past the report. */
+v1 = r.v1 >> 4 & 0x0FFFFF;
 
 // display the values
 DisplayValues(v0, v1);
+}
+
+
+/*	PutValuesReport
+	Display the values in a report received from the host
+*/
+void PutValuesReport(
+	const volatile uint8_t *report
+	)
+{
+PutValues(report + 1);
+}
+
+
+/*	PutPanelReport
+	Apply the records in a panel report received from the host
+	
+	A whole panel update arrives in one packet (one transaction), rather than
+	one report per item.  Records of the same type replace each other: the
+	packet is parsed first, and only the last record of each type is
+	applied; so an earlier values record never reaches the display.  A
+	malformed packet is not applied at all.
+*/
+static void PutPanelReport(
+	const volatile uint8_t *report,
+	uint8_t		reportL
+	)
+{
+// no room for the record count?
+if (reportL < 2) { Error(); return; }
+
+const volatile uint8_t *record = report + 2;
+uint8_t recordsL = reportL - 2;
+
+// the last record of each type
+const volatile uint8_t *values = NULL, *intensity = NULL;
+
+// for each record
+for (uint8_t n = report[1]; n; n--) {
+	// no room for the record type?
+	if (recordsL == 0) { Error(); return; }
+	
+	// on record type
+	switch (*record) {
+		case kPanelRecordValues:
+			if (recordsL < 1 + kValuesLength) { Error(); return; }
+			values = record + 1;
+			record += 1 + kValuesLength, recordsL -= 1 + kValuesLength;
+			break;
+		
+		case kPanelRecordIntensity:
+			if (recordsL < 1 + 1) { Error(); return; }
+			intensity = record + 1;
+			record += 1 + 1, recordsL -= 1 + 1;
+			break;
+		
+		default:
+			Error();
+			return;
+		}
+	}
+
+// apply them
+if (intensity) DisplayIntensity(*intensity);
+if (values) PutValues(values);
+}
+
+
+/*	PackInput
+	Construct an input report from the two 20-bit values, the keys pressed,
+	and when
+*/
+static void PackInput(
+	volatile uint8_t *buffer,
+	__uint24	value0,
+	__uint24	value1,
+	uint32_t	keys,
+	const Timestamp	*time
+	)
+{
+buffer[0] = kReportIDValues;
+PackValues(buffer + 1, value0, value1);
+
+buffer[kValuesReportLength + 0] = ((uint8_t*) &keys)[0];
+buffer[kValuesReportLength + 1] = ((uint8_t*) &keys)[1];
+buffer[kValuesReportLength + 2] = ((uint8_t*) &keys)[2];
+buffer[kValuesReportLength + 3] = ((uint8_t*) &keys)[3];
+
+#if REPORT_TIMESTAMPS
+	buffer[kValuesReportLength + 4] = (uint8_t) time->frame;
+	buffer[kValuesReportLength + 5] = (uint8_t) (time->frame >> 8);
+	buffer[kValuesReportLength + 6] = (uint8_t) time->subframe;
+	buffer[kValuesReportLength + 7] = (uint8_t) (time->subframe >> 8);
+
+#else
+	(void) time;
+	#endif
+}
+
+
+/*	GetValuesReport
+	Construct a report with the values currently displayed
+*/
+void GetValuesReport(
+	uint8_t		*report
+	)
+{
+report[0] = kReportIDValues;
+PackValues(report + 1, gValue0, gValue1);
+}
+
+
+/*	GetInputReport
+	Construct an input report with the values currently displayed
+	
+	Key presses are only ever reported once, through Endpoint 1; so there
+	are none here.
+*/
+void GetInputReport(
+	uint8_t		*report
+	)
+{
+Timestamp now;
+GetTimestamp(&now);
+
+PackInput(report, gValue0, gValue1, 0, &now);
+}
+
+
+/*	HandleEndpoint1OUT
+	Receive HID report for display
+*/
+static void HandleEndpoint1OUT(
+	uint8_t		pingPong
+	)
+{
+const volatile uint8_t *const report = ep1OutBuffer[pingPong];
+const uint8_t reportL = ep1Out[pingPong].CNT;
+
+gCounters.reportsReceived++;
+
+#if TRACE
+	Trace(kTraceOUTReceived);
+	#endif
+
+// display the HID report
+/* The other buffer descriptor is armed; so the SIE can already be receiving
+   the next report while we're handling this one. */
+switch (report[0]) {
+	case kReportIDValues:
+		if (reportL != kValuesReportLength) { Error(); break; }
+		PutValuesReport(report);
+		break;
+	
+	case kReportIDPanel:
+		PutPanelReport(report, reportL);
+		break;
+	
+	default:
+		Error();
+	}
 
 // wait for new OUT transfers
-ArmEndpoint1OUT();
+ArmEndpoint1OUT(pingPong);
 }
 
 
+static void OfferReports(void);
+
+
+/*	HandleEndpoint1IN
+	The host collected a report
+*/
 static void HandleEndpoint1IN()
 {
-/* Do nothing; this will cause subsequent INs to return NACK [***].  We'll arm
-   the endpoint once there is new data.*/
-// *** respect SetIdle
+gCounters.reportsSent++;
 
-// prepare the data toggle for a next IN transaction
-/* [USB 8.5.4
-	When an endpoint is using the interrupt transfer mechanism
-	for actual interrupt data, the data toggle protocol must be followed. "
-*/
-gToggleIN = !gToggleIN;
+#if TRACE
+	Trace(kTraceINSent);
+	#endif
+
+/* The data toggle for the next IN transaction was already prepared when this
+   buffer descriptor was armed. */
+
+// offer whatever is waiting for the buffer descriptor that just came back
+/* If nothing is, subsequent INs return NAK until there is new data, or the
+   idle period elapses. */
+OfferReports();
 }
 
 
-/*	SendValues
-	Send updated values to the host
+/*	OfferReport
+	Have the given values and keys collected by the next IN transaction
 */
-void SendValues(
+static void OfferReport(
 	__uint24	value0,
-	__uint24	value1
+	__uint24	value1,
+	uint32_t	keys,
+	const Timestamp	*time
 	)
 {
-// construct a report from the two 20-bit values *** assembly
-Report r;
-r.v0 = value0;
-r.v1 = value1 << 4;
-r.b[2] = (value0 >> 16) | ((value1 & 0x0F) << 4);
+// SIE still owns the buffer (both previous reports not yet collected)?
+if (ep1In[gPingPongIN].STAT.UOWN) { Error(); return; }
 
-ep1InBuffer[0] = r.b[0];
-ep1InBuffer[1] = r.b[1];
-ep1InBuffer[2] = r.b[2];
-ep1InBuffer[3] = r.b[3];
-ep1InBuffer[4] = r.b[4];
+PackInput(ep1InBuffer[gPingPongIN], value0, value1, keys, time);
 
 // send report on next IN transaction
 ArmEndpoint1IN();
+
+gSent = true;
+
+// restart the idle period [HID §7.2.4]
+if (gIdleRate)
+	TimerStart(&gIdleTimer, IdleElapsed, gIdleRate * 4, gIdleRate * 4);
+}
+
+
+/*	OfferReports
+	Offer the waiting reports, oldest key presses first, for as long as there
+	are IN buffer descriptors to put them in
+*/
+static void OfferReports()
+{
+while (!ep1In[gPingPongIN].STAT.UOWN) {
+	// key presses waiting?
+	if (gKeysQueueN) {
+		OfferReport(gReportValue0, gReportValue1, gKeysQueue[gKeysQueueHead], &gKeysQueueTimes[gKeysQueueHead]);
+		
+		gKeysQueueHead = (gKeysQueueHead + 1) % kKeysQueueLength;
+		gKeysQueueN--;
+		
+		/* Follow up with a report without the keys; so a host that treats the
+		   bitmap as button state sees each press as a down and an up. */
+		gReportValuesPending = true;
+		}
+	
+	// new values waiting?
+	else if (gReportValuesPending) {
+		OfferReport(gReportValue0, gReportValue1, 0, &gReportValuesTime);
+		gReportValuesPending = false;
+		}
+	
+	else
+		break;
+	}
+}
+
+
+/*	SendReport
+	Send updated values, and the keys pressed since the previous call, to the
+	host
+	
+	A report that is identical to the previous one is not sent: the host
+	already has those values, and at short polling intervals duplicates would
+	only cost bus time (and host processing).  Repeating unchanged values is
+	left to the idle rate.
+	
+	While the SIE owns both IN buffer descriptors (the host hasn't collected
+	the previous two reports yet), the report waits; see gReportValue and
+	gKeysQueue.
+	
+	The time is that of the event that caused the change (see REPORT_TIMESTAMPS).
+*/
+void SendReport(
+	__uint24	value0,
+	__uint24	value1,
+	uint32_t	keys,
+	const Timestamp	*time
+	)
+{
+// values changed from what the host was (or is about to be) sent?
+if (!gSent || value0 != gReportValue0 || value1 != gReportValue1) {
+	gReportValuesTime = *time;
+	gReportValuesPending = true;
+	}
+
+gReportValue0 = value0;
+gReportValue1 = value1;
+
+// key presses queue up
+if (keys) {
+	// queue full?
+	/* Merge into the newest entry rather than dropping a press: the
+	   presses it holds then arrive together instead of in order (with the
+	   time of the earliest). */
+	if (gKeysQueueN == kKeysQueueLength) {
+		gKeysQueue[(gKeysQueueHead + kKeysQueueLength - 1) % kKeysQueueLength] |= keys;
+		gCounters.keysMerged++;
+		}
+	
+	else {
+		const uint8_t tail = (gKeysQueueHead + gKeysQueueN++) % kKeysQueueLength;
+		gKeysQueue[tail] = keys;
+		gKeysQueueTimes[tail] = *time;
+		}
+	}
+
+OfferReports();
+
+// still waiting for the host to collect the previous reports?
+if (gReportValuesPending || gKeysQueueN)
+	gCounters.reportsWaited++;
+}
+
+
+/*	GetIdleRate
+	[HID §7.2.4]
+*/
+uint8_t GetIdleRate()
+{
+return gIdleRate;
+}
+
+
+/*	SetIdleRate
+	[HID §7.2.4] Repeat the report every given number of 4 ms units while
+	nothing changes; zero to only report changes
+*/
+void SetIdleRate(
+	uint8_t		rate
+	)
+{
+gIdleRate = rate;
+
+// start a new idle period at the new rate
+if (rate)
+	TimerStart(&gIdleTimer, IdleElapsed, rate * 4, rate * 4);
+
+else
+	TimerStop(&gIdleTimer);
+}
+
+
+/*	IdleElapsed
+	Repeat the report when the idle period has elapsed
+*/
+static void IdleElapsed()
+{
+// not configured?
+if (!UEP1bits.EPINEN) return;
+
+// host hasn't even collected the last report?
+/* Then it has no reason to hear from us again; the periodic timer has
+   already started another period. */
+if (ep1In[gPingPongIN ^ 1].STAT.UOWN) return;
+
+// report the current values again (restarts the idle period)
+/* Key presses were already reported */
+Timestamp now;
+GetTimestamp(&now);
+OfferReport(gValue0, gValue1, 0, &now);
 }
 
 
@@ -188,7 +706,7 @@ ArmEndpoint1IN();
 extern void HandleUSBTransactionEndpoint1()
 {
 if (USTATbits.DIR == 0)
-	HandleEndpoint1OUT();
+	HandleEndpoint1OUT(USTATbits.PPBI);
 
 else
 	HandleEndpoint1IN();
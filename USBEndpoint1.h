@@ -14,8 +14,76 @@
 
 #pragma once
 
+#include "Timer1.h"
 
+
+/*	kReportID
+	[HID §5.6] With more than one report format, each report starts with the
+	ID of its format
+*/
+enum {
+	kReportIDValues = 1,			// the two values (Input: and keys pressed)
+	kReportIDPanel,				// records for a whole panel update (Output)
+	kReportIDCounters,			// event counters (Feature; see Counters)
+	kReportIDProfile			// hot path statistics (Feature; only with PROFILE, see Profile)
+	};
+
+
+/*	kValuesLength
+	Two 20-bit values
+*/
+enum { kValuesLength = 5 };
+
+
+/*	kValuesReportLength
+	Report ID, and the two values
+*/
+enum { kValuesReportLength = 1 + kValuesLength };
+
+
+/*	REPORT_TIMESTAMPS
+	Whether Input reports end with the Timestamp (frame number, and µs into
+	the frame) of the event they report; so the host can tell how long the
+	report waited to be collected
+	
+	Select at build time by defining REPORT_TIMESTAMPS as 1 in the project's
+	preprocessor macros.  This costs a Start-of-Frame interrupt every 1 ms.
+*/
+#if !defined(REPORT_TIMESTAMPS)
+	#define REPORT_TIMESTAMPS 0
+	#endif
+
+
+/*	kInputReportLength
+	The values report, followed by a 32-bit bitmap of the keys pressed since
+	the previous report; and optionally, the 16-bit frame and µs of the event
+*/
+enum { kInputReportLength = kValuesReportLength + 4 + (REPORT_TIMESTAMPS ? 4 : 0) };
+
+
+/*	kPanelReportLength
+	Report ID, record count, and the records; one full Endpoint 1 packet
+*/
+enum { kPanelReportLength = 64 };
+
+
+/*	kPanelRecord
+	Types of the records in a panel report; each type byte is followed by the
+	record data, of a fixed length for the type
+*/
+enum {
+	kPanelRecordValues = 1,			// kValuesLength: the two values
+	kPanelRecordIntensity			// 1: display intensity (0 to 15)
+	};
+
+
+extern void ClearEndpoint1Halt(bool);
 extern void DisableEndpoint1(void);
 extern void EnableEndpoint1(void);
+extern uint8_t GetIdleRate(void);
+extern void GetInputReport(uint8_t *);
+extern void GetValuesReport(uint8_t *);
 extern void HandleUSBTransactionEndpoint1(void);
-extern void SendValues(__uint24, __uint24);
+extern void PutValuesReport(const volatile uint8_t *);
+extern void SendReport(__uint24, __uint24, uint32_t, const Timestamp *);
+extern void SetIdleRate(uint8_t);
@@ -15,7 +15,7 @@
 	for example, the SPI source code is aware of USB.
 	
 	
-	Note throughout implementation-defined behavior [XC8 11.10]:
+	Note throughout implementation-defined behavior [XC8 §11.10]:
 	
 	"The first bit-field defined in a structure is allocated the LSb position
 	in the storage unit.  Subsequent bit-fields are allocated higher-order bits."
@@ -98,33 +98,156 @@
 // #pragma config statements should precede project file includes.
 // Use project enums instead of #define for ON and OFF.
 
+#include <stdbool.h>
+
 #include <xc.h>
 
+#include "Counters.h"
 #include "Display.h"
 #include "LED.h"
+#include "Profile.h"
 #include "SPI.h"
 #include "Switches.h"
+#include "Task.h"
+#include "Timer1.h"
+#include "Timer2.h"
 #include "USB.h"
-#include "Timer0.h"
-
 
-/*	ISR
-	Interrupt Service Routine
 
+/*	ISRHigh
+	High priority Interrupt Service Routine
+	
 	Note throughout that flags may be set even without the corresponding interrupts
 	being enabled
 	
 	Clear the condition flags immediately after making the decision to handle it;
 	because the handling itself may trigger the condition again
+	
+	Interrupt priorities [PIC §9] are assigned by each of the peripheral
+	initializations.  High priority is for the sources that hold up the bus
+	they serve when they're kept waiting: SPI (refill the next byte) and USB
+	(the SIE NAKs until a transaction has been handled).  These can interrupt
+	the low priority handler; so a high priority source only ever waits behind
+	the hardware entry latency and the other high priority handler.
+	
+	The handlers themselves only do what can't wait, and post the rest to run
+	from main() (see Task.c).
+	
+	Latency, from the condition flag to its handling, is measured with
+	PROFILE: kProfileSPILatency, from when the SPI byte on the bus was due
+	to be shifted out (see gSPIByteDone).  USBIF waits behind the same
+	things as SSPIF, but has no time of its own to measure against.
+	
+	The worst case to expect, counted from the instructions; 2 instruction
+	cycles per µs:
+	
+		entry and context save				about 30 cycles
+			(the XC8 prologue: saving WREG, STATUS and BSR
+			in the shadow registers, then FSR0/1/2, PROD,
+			TBLPTR, TABLAT and the compiler temporaries;
+			about 25 instructions)
+		main-line code with GIE clear			up to about 130
+			(SPIStartExchange: the queue search, and
+			SPIStartHead; GetCountersReport: copying 16
+			bytes at about 7 cycles each)
+		the other high priority source			up to about 200
+			(Start-of-Frame starting a frame of digits:
+			USBInterruptService's dispatch, and the
+			SPIStartExchange above)
+	
+	so about 360 cycles (180 µs), for SSPIF and USBIF alike.  Neither has a
+	deadline: the SPI bus idles, and the SIE NAKs, until they are handled.
+	But the time Timer1StartOfFrame takes is late by as much.
+*/
+void __interrupt(high_priority) ISRHigh(void)
+{
+#if PROFILE
+	const uint16_t entry = Timer1Read();
+	#endif
+
+// SPI?
+if (PIR1bits.SSPIF) {
+	// clear condition flag *** ?
+	PIR1bits.SSPIF = 0;
+	
+	// service interrupt
+	#if PROFILE
+		ProfileRecord(kProfileSPILatency, gSPIByteDone);
+		const uint16_t start = Timer1Read();
+		#endif
+	SPIServiceInterrupt();
+	#if PROFILE
+		ProfileRecord(kProfileSPIInterrupt, start);
+		#endif
+	}
+
+// USB?
+if (PIR3bits.USBIF) {
+	// clear USB condition
+	PIR3bits.USBIF = 0;
+	
+	// service interrupt
+	#if PROFILE
+		const uint16_t start = Timer1Read();
+		#endif
+	USBInterruptService();
+	#if PROFILE
+		ProfileRecord(kProfileUSBInterrupt, start);
+		#endif
+	}
+
+#if PROFILE
+	// longest time in here so far (see Counters)
+	const uint16_t cycles = (uint16_t) (Timer1Read() - entry) * kCyclesPerMicrosecond;
+	if (cycles > gCounters.interruptCycles) gCounters.interruptCycles = cycles;
+	#endif
+}
+
+
+/*	ISRLow
+	Low priority Interrupt Service Routine
+	
+	For the human-speed sources: the timer tick, the push-buttons, and the
+	MAX6954 key scan IRQ.  Anything here that shares state with the high
+	priority handlers has to keep them out (INTCONbits.GIEH) while it does.
+	
+	Latency is measured with PROFILE for the tick: kProfileTickLatency, from
+	when Timer 2 matched (see Timer2Match).  IOCIF and INT2IF wait behind the
+	same things; but they come from the outside world, at no time the
+	firmware knows.
+	
+	The worst case to expect, counted as for ISRHigh:
+	
+		entry and context save				about 40 cycles
+			(as ISRHigh's, but WREG, STATUS and BSR
+			saved in software too)
+		main-line code with GIEL or GIE clear		up to about 130
+			(SPIStartExchange as above; TimerStart's
+			insertion into the timer list)
+		one pass of ISRHigh				up to about 250
+			(its entry, and the Start-of-Frame above;
+			exit through the fast return)
+		the other low priority sources			up to about 150
+			(the tick expiring timers: TimerTick's walk
+			of the list, and posting their tasks)
+	
+	so about 570 cycles (285 µs), for TMR2IF, IOCIF and INT2IF alike.  Once
+	entered, the handler is itself interrupted by every SPI byte while an
+	exchange is on the bus; which can about double the time it takes.  The
+	tightest deadline is the tick's: TMR2IF is cleared on entry, so it only
+	has to be handled within the 1 ms period (see TickTest).
 */
-void __interrupt(high_priority) ISR(void)
+void __interrupt(low_priority) ISRLow(void)
 {
 // timer?
-if (INTCONbits.TMR0IF) {
+if (PIR1bits.TMR2IF) {
 	// clear condition flag
-	INTCONbits.TMR0IF = 0;
+	PIR1bits.TMR2IF = 0;
 	
-	Timer0InterruptService();
+	#if PROFILE
+		ProfileRecord(kProfileTickLatency, Timer2Match());
+		#endif
+	Timer2InterruptService();
 	}
 
 // interrupt on change?
@@ -142,24 +265,6 @@ if (INTCON3bits.INT2IF) {
 	
 	ControlsServiceInterrupt();
 	}
-
-// SPI?
-if (PIR1bits.SSPIF) {
-	// clear condition flag *** ?
-	PIR1bits.SSPIF = 0;
-	
-	// service interrupt
-	SPIServiceInterrupt();
-	}
-
-// USB?
-if (PIR3bits.USBIF) {
-	// clear USB condition
-	PIR3bits.USBIF = 0;
-	
-	// service interrupt
-	USBInterruptService();
-	}
 }
 
 
@@ -170,6 +275,7 @@ int main(void)
 {
 // INTCON.GIE is clear (interrupts disabled) at power-on reset
 // RCONbits.IPEN is clear (priority levels disabled) at power-on reset
+// IPRx are set (all sources high priority) at power-on reset
 
 INTCONbits.INT0IF = 0;
 
@@ -179,7 +285,7 @@ OSCCONbits.SCS = 0;			// primary clock (already done after reset)
 OSCCONbits.IRCF = 7;			// 16 MHz internal oscillator
 OSCCONbits.IDLEN = 1;			// enable Idle (as opposed to Sleep) modes
 
-OSCTUNEbits.SPLLMULT = 1;		// PLL 3
+OSCTUNEbits.SPLLMULT = 1;		// PLL ×3
 OSCCON2bits.PLLEN = 1;			// enable PLL multiplier
 
 #if defined(__18F45K50)
@@ -202,17 +308,36 @@ SwitchesInitialize();
 // LEDs
 LEDInitialize();
 
-// Timer 0
-Timer0Initialize();
+// Timer 1
+Timer1Initialize();
+
+// Timer 2
+Timer2Initialize();
 
 // USB
 USBInitialize();
 
-// enable peripheral interrupts (needed for USB and SPI)
-INTCONbits.PEIE = 1;
+// enable interrupt priority levels
+RCONbits.IPEN = 1;
 
-// enable global interrupts
-INTCONbits.GIE = 1;
+// enable low priority interrupts
+INTCONbits.GIEL = 1;
 
-for (;;) SLEEP();
+// enable high priority interrupts (and so all interrupts)
+INTCONbits.GIEH = 1;
+
+for (;;) {
+	// run the work posted by the interrupt handlers
+	while (TaskRun());
+	
+	// sleep until the next interrupt
+	/* With interrupts disabled, so that an interrupt that posts a task after
+	   we've looked doesn't leave that task waiting for the interrupt after.
+	   An enabled interrupt source still wakes the device, which then carries on
+	   after SLEEP [PIC: Exit by Interrupt]; the handler runs as soon as
+	   interrupts are enabled again. */
+	INTCONbits.GIEH = 0;
+	if (!TaskPending()) SLEEP();
+	INTCONbits.GIEH = 1;
+	}
 }
\ No newline at end of file
@@ -51,17 +51,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=main.c USB.c USBEndpoint1.c USBEndpoint0.c Timer0.c Switches.c LED.c SPI.c Display.c
+SOURCEFILES_QUOTED_IF_SPACED=main.c USB.c USBEndpoint1.c USBEndpoint0.c Timer2.c Switches.c LED.c SPI.c Display.c Task.c Timer.c Timer1.c Profile.c Counters.c Trace.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/main.p1 ${OBJECTDIR}/USB.p1 ${OBJECTDIR}/USBEndpoint1.p1 ${OBJECTDIR}/USBEndpoint0.p1 ${OBJECTDIR}/Timer0.p1 ${OBJECTDIR}/Switches.p1 ${OBJECTDIR}/LED.p1 ${OBJECTDIR}/SPI.p1 ${OBJECTDIR}/Display.p1
-POSSIBLE_DEPFILES=${OBJECTDIR}/main.p1.d ${OBJECTDIR}/USB.p1.d ${OBJECTDIR}/USBEndpoint1.p1.d ${OBJECTDIR}/USBEndpoint0.p1.d ${OBJECTDIR}/Timer0.p1.d ${OBJECTDIR}/Switches.p1.d ${OBJECTDIR}/LED.p1.d ${OBJECTDIR}/SPI.p1.d ${OBJECTDIR}/Display.p1.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/main.p1 ${OBJECTDIR}/USB.p1 ${OBJECTDIR}/USBEndpoint1.p1 ${OBJECTDIR}/USBEndpoint0.p1 ${OBJECTDIR}/Timer2.p1 ${OBJECTDIR}/Switches.p1 ${OBJECTDIR}/LED.p1 ${OBJECTDIR}/SPI.p1 ${OBJECTDIR}/Display.p1 ${OBJECTDIR}/Task.p1 ${OBJECTDIR}/Timer.p1 ${OBJECTDIR}/Timer1.p1 ${OBJECTDIR}/Profile.p1 ${OBJECTDIR}/Counters.p1 ${OBJECTDIR}/Trace.p1
+POSSIBLE_DEPFILES=${OBJECTDIR}/main.p1.d ${OBJECTDIR}/USB.p1.d ${OBJECTDIR}/USBEndpoint1.p1.d ${OBJECTDIR}/USBEndpoint0.p1.d ${OBJECTDIR}/Timer2.p1.d ${OBJECTDIR}/Switches.p1.d ${OBJECTDIR}/LED.p1.d ${OBJECTDIR}/SPI.p1.d ${OBJECTDIR}/Display.p1.d ${OBJECTDIR}/Task.p1.d ${OBJECTDIR}/Timer.p1.d ${OBJECTDIR}/Timer1.p1.d ${OBJECTDIR}/Profile.p1.d ${OBJECTDIR}/Counters.p1.d ${OBJECTDIR}/Trace.p1.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/main.p1 ${OBJECTDIR}/USB.p1 ${OBJECTDIR}/USBEndpoint1.p1 ${OBJECTDIR}/USBEndpoint0.p1 ${OBJECTDIR}/Timer0.p1 ${OBJECTDIR}/Switches.p1 ${OBJECTDIR}/LED.p1 ${OBJECTDIR}/SPI.p1 ${OBJECTDIR}/Display.p1
+OBJECTFILES=${OBJECTDIR}/main.p1 ${OBJECTDIR}/USB.p1 ${OBJECTDIR}/USBEndpoint1.p1 ${OBJECTDIR}/USBEndpoint0.p1 ${OBJECTDIR}/Timer2.p1 ${OBJECTDIR}/Switches.p1 ${OBJECTDIR}/LED.p1 ${OBJECTDIR}/SPI.p1 ${OBJECTDIR}/Display.p1 ${OBJECTDIR}/Task.p1 ${OBJECTDIR}/Timer.p1 ${OBJECTDIR}/Timer1.p1 ${OBJECTDIR}/Profile.p1 ${OBJECTDIR}/Counters.p1 ${OBJECTDIR}/Trace.p1
 
 # Source Files
-SOURCEFILES=main.c USB.c USBEndpoint1.c USBEndpoint0.c Timer0.c Switches.c LED.c SPI.c Display.c
+SOURCEFILES=main.c USB.c USBEndpoint1.c USBEndpoint0.c Timer2.c Switches.c LED.c SPI.c Display.c Task.c Timer.c Timer1.c Profile.c Counters.c Trace.c
 
 
 
@@ -120,13 +120,13 @@ ${OBJECTDIR}/USBEndpoint0.p1: USBEndpoint0.c  nbproject/Makefile-${CND_CONF}.mk
 	@-${MV} ${OBJECTDIR}/USBEndpoint0.d ${OBJECTDIR}/USBEndpoint0.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/USBEndpoint0.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
-${OBJECTDIR}/Timer0.p1: Timer0.c  nbproject/Makefile-${CND_CONF}.mk 
+${OBJECTDIR}/Timer2.p1: Timer2.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}" 
-	@${RM} ${OBJECTDIR}/Timer0.p1.d 
-	@${RM} ${OBJECTDIR}/Timer0.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -mdebugger=pickit5   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Timer0.p1 Timer0.c 
-	@-${MV} ${OBJECTDIR}/Timer0.d ${OBJECTDIR}/Timer0.p1.d 
-	@${FIXDEPS} ${OBJECTDIR}/Timer0.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	@${RM} ${OBJECTDIR}/Timer2.p1.d 
+	@${RM} ${OBJECTDIR}/Timer2.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -mdebugger=pickit5   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Timer2.p1 Timer2.c 
+	@-${MV} ${OBJECTDIR}/Timer2.d ${OBJECTDIR}/Timer2.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Timer2.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/Switches.p1: Switches.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}" 
@@ -160,6 +160,54 @@ ${OBJECTDIR}/Display.p1: Display.c  nbproject/Makefile-${CND_CONF}.mk
 	@-${MV} ${OBJECTDIR}/Display.d ${OBJECTDIR}/Display.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/Display.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/Trace.p1: Trace.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Trace.p1.d 
+	@${RM} ${OBJECTDIR}/Trace.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -mdebugger=pickit5   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Trace.p1 Trace.c 
+	@-${MV} ${OBJECTDIR}/Trace.d ${OBJECTDIR}/Trace.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Trace.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/Counters.p1: Counters.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Counters.p1.d 
+	@${RM} ${OBJECTDIR}/Counters.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -mdebugger=pickit5   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Counters.p1 Counters.c 
+	@-${MV} ${OBJECTDIR}/Counters.d ${OBJECTDIR}/Counters.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Counters.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/Profile.p1: Profile.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Profile.p1.d 
+	@${RM} ${OBJECTDIR}/Profile.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -mdebugger=pickit5   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Profile.p1 Profile.c 
+	@-${MV} ${OBJECTDIR}/Profile.d ${OBJECTDIR}/Profile.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Profile.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/Timer1.p1: Timer1.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Timer1.p1.d 
+	@${RM} ${OBJECTDIR}/Timer1.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -mdebugger=pickit5   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Timer1.p1 Timer1.c 
+	@-${MV} ${OBJECTDIR}/Timer1.d ${OBJECTDIR}/Timer1.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Timer1.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/Timer.p1: Timer.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Timer.p1.d 
+	@${RM} ${OBJECTDIR}/Timer.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -mdebugger=pickit5   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Timer.p1 Timer.c 
+	@-${MV} ${OBJECTDIR}/Timer.d ${OBJECTDIR}/Timer.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Timer.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/Task.p1: Task.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Task.p1.d 
+	@${RM} ${OBJECTDIR}/Task.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c  -D__DEBUG=1  -mdebugger=pickit5   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Task.p1 Task.c 
+	@-${MV} ${OBJECTDIR}/Task.d ${OBJECTDIR}/Task.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Task.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 else
 ${OBJECTDIR}/main.p1: main.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}" 
@@ -193,13 +241,13 @@ ${OBJECTDIR}/USBEndpoint0.p1: USBEndpoint0.c  nbproject/Makefile-${CND_CONF}.mk
 	@-${MV} ${OBJECTDIR}/USBEndpoint0.d ${OBJECTDIR}/USBEndpoint0.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/USBEndpoint0.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
-${OBJECTDIR}/Timer0.p1: Timer0.c  nbproject/Makefile-${CND_CONF}.mk 
+${OBJECTDIR}/Timer2.p1: Timer2.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}" 
-	@${RM} ${OBJECTDIR}/Timer0.p1.d 
-	@${RM} ${OBJECTDIR}/Timer0.p1 
-	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Timer0.p1 Timer0.c 
-	@-${MV} ${OBJECTDIR}/Timer0.d ${OBJECTDIR}/Timer0.p1.d 
-	@${FIXDEPS} ${OBJECTDIR}/Timer0.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	@${RM} ${OBJECTDIR}/Timer2.p1.d 
+	@${RM} ${OBJECTDIR}/Timer2.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Timer2.p1 Timer2.c 
+	@-${MV} ${OBJECTDIR}/Timer2.d ${OBJECTDIR}/Timer2.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Timer2.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
 ${OBJECTDIR}/Switches.p1: Switches.c  nbproject/Makefile-${CND_CONF}.mk 
 	@${MKDIR} "${OBJECTDIR}" 
@@ -233,6 +281,54 @@ ${OBJECTDIR}/Display.p1: Display.c  nbproject/Makefile-${CND_CONF}.mk
 	@-${MV} ${OBJECTDIR}/Display.d ${OBJECTDIR}/Display.p1.d 
 	@${FIXDEPS} ${OBJECTDIR}/Display.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
 	
+${OBJECTDIR}/Trace.p1: Trace.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Trace.p1.d 
+	@${RM} ${OBJECTDIR}/Trace.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Trace.p1 Trace.c 
+	@-${MV} ${OBJECTDIR}/Trace.d ${OBJECTDIR}/Trace.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Trace.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/Counters.p1: Counters.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Counters.p1.d 
+	@${RM} ${OBJECTDIR}/Counters.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Counters.p1 Counters.c 
+	@-${MV} ${OBJECTDIR}/Counters.d ${OBJECTDIR}/Counters.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Counters.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/Profile.p1: Profile.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Profile.p1.d 
+	@${RM} ${OBJECTDIR}/Profile.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Profile.p1 Profile.c 
+	@-${MV} ${OBJECTDIR}/Profile.d ${OBJECTDIR}/Profile.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Profile.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/Timer1.p1: Timer1.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Timer1.p1.d 
+	@${RM} ${OBJECTDIR}/Timer1.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Timer1.p1 Timer1.c 
+	@-${MV} ${OBJECTDIR}/Timer1.d ${OBJECTDIR}/Timer1.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Timer1.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/Timer.p1: Timer.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Timer.p1.d 
+	@${RM} ${OBJECTDIR}/Timer.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Timer.p1 Timer.c 
+	@-${MV} ${OBJECTDIR}/Timer.d ${OBJECTDIR}/Timer.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Timer.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
+${OBJECTDIR}/Task.p1: Task.c  nbproject/Makefile-${CND_CONF}.mk 
+	@${MKDIR} "${OBJECTDIR}" 
+	@${RM} ${OBJECTDIR}/Task.p1.d 
+	@${RM} ${OBJECTDIR}/Task.p1 
+	${MP_CC} $(MP_EXTRA_CC_PRE) -mcpu=$(MP_PROCESSOR_OPTION) -c   -mdfp="${DFP_DIR}/xc8"  -fno-short-double -fno-short-float -memi=wordwrite -O0 -fasmfile -Og -maddrqual=ignore -xassembler-with-cpp -mwarn=-3 -Wa,-a -DXPRJ_default=$(CND_CONF)  -msummary=-psect,-class,+mem,-hex,-file  -ginhx32 -Wl,--data-init -mno-keep-startup -mno-download -mno-default-config-bits $(COMPARISON_BUILD)  -std=c99 -gdwarf-3 -mstack=compiled:auto:auto:auto -Xparser -Wno-dangling-else     -o ${OBJECTDIR}/Task.p1 Task.c 
+	@-${MV} ${OBJECTDIR}/Task.d ${OBJECTDIR}/Task.p1.d 
+	@${FIXDEPS} ${OBJECTDIR}/Task.p1.d $(SILENT) -rsi ${MP_CC_DIR}../  
+	
 endif
 
 # ------------------------------------------------------------------------------------
@@ -0,0 +1,201 @@
+/*
+	Harness
+	
+	The hardware around the firmware, for the host-side tests
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+ 	References:
+		[USB] Universal Serial Bus Specification, Revision 2.0
+		[PIC] Microchip PIC18(L)F2X/45K50 Data Sheet
+	
+	Each test program runs the firmware from reset once: Start initializes
+	it as main() does, and from then on the test plays the part of the
+	interrupt sources (Tick, the SPI bus, the USB host), calling the
+	interrupt handlers as the hardware would and running the posted tasks as
+	main() would.  Everything happens in order; an interrupt never arrives in
+	the middle of main-line code.
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <xc.h>
+
+#include "Counters.h"
+#include "LED.h"
+#include "SPI.h"
+#include "Switches.h"
+#include "Task.h"
+#include "Timer1.h"
+#include "Timer2.h"
+#include "USB.h"
+#include "Harness.h"
+
+
+/*	gChecks
+	Checks made, and how many of them failed
+*/
+static unsigned gChecks, gFailures;
+
+
+/*	Check
+*/
+void Check(
+	bool		condition,
+	const char	*text,
+	const char	*file,
+	int		line
+	)
+{
+gChecks++;
+
+if (!condition) {
+	gFailures++;
+	fprintf(stderr, "%s:%d: check failed: %s\n", file, line, text);
+	}
+}
+
+
+/*	Finish
+	Report; the exit status of the test program
+	
+	Any call of Error() is a failure, unless the test expected it and reset
+	the count.
+*/
+int Finish()
+{
+CHECK(gCounters.errors == 0);
+
+fprintf(stderr, "%u checks, %u failed\n", gChecks, gFailures);
+return gFailures != 0;
+}
+
+
+/*	gSPIDevice
+	Nothing on the bus: shifts in all ones
+*/
+uint8_t (*gSPIDevice)(uint8_t) = NULL;
+
+
+/*	gMicroseconds
+	Time since Start, from which Timer 1 counts
+*/
+uint32_t gMicroseconds;
+
+
+/*	Advance
+	Let the given number of µs pass on Timer 1
+*/
+static void Advance(
+	uint32_t	us
+	)
+{
+gMicroseconds += us;
+TMR1H = (uint8_t) (gMicroseconds >> 8);
+TMR1L = (uint8_t) gMicroseconds;
+}
+
+
+/*	ShiftSPI
+	Shift out the byte in SSP1BUF, and shift one in; then interrupt
+	
+	A byte takes 8 SCK periods at 2 MHz (see SPIInitialize).
+*/
+static void ShiftSPI()
+{
+Advance(4);
+
+const uint8_t out = (uint8_t) SSP1BUF;
+
+// only a selected device drives the data line
+const uint8_t in = !LATAbits.LATA5 && gSPIDevice ? (*gSPIDevice)(out) : 0xFF;
+
+SSP1BUF = kShiftedIn | in;
+PIR1bits.SSPIF = 1;
+ISRHigh();
+}
+
+
+/*	Run
+	What main() does between interrupts: run the posted tasks
+	
+	The SPI bus runs as fast as the firmware keeps it busy; the exchanges
+	complete before any other interrupt.
+*/
+void Run()
+{
+for (;;) {
+	if (!(SSP1BUF & kShiftedIn))
+		ShiftSPI();
+	
+	else if (!TaskRun())
+		break;
+	}
+
+// catch up with the last change of chip select
+(void) LATAbits;
+}
+
+
+/*	Start
+	The firmware from reset, as main() initializes it
+*/
+void Start()
+{
+// nothing shifted out yet
+SSP1BUF = kShiftedIn;
+
+// chip select pin idles high, with the pull-up
+LATAbits.LATA5 = 1;
+
+SPIInitialize();
+SwitchesInitialize();
+LEDInitialize();
+Timer1Initialize();
+Timer2Initialize();
+USBInitialize();
+
+RCONbits.IPEN = 1;
+INTCONbits.GIEL = 1;
+INTCONbits.GIEH = 1;
+
+Run();
+}
+
+
+/*	Tick
+	Let the given number of ms pass: the USB host starts a frame [USB §8.4.3],
+	and the Timer 2 period elapses, every 1 ms
+	
+	On the ms, as Timer 1 counts them; whatever time the SPI bus took in
+	between.
+*/
+void Tick(
+	uint16_t	ms
+	)
+{
+while (ms--) {
+	Advance(1000 - gMicroseconds % 1000);
+	
+	// Start-of-Frame
+	if (UCONbits.USBEN && !UCONbits.SUSPND) {
+		const uint16_t frame = ((uint16_t) UFRMH << 8 | UFRML) + 1;
+		UFRMH = (frame >> 8) & 0x07;
+		UFRML = (uint8_t) frame;
+		
+		UIRbits.SOFIF = 1;
+		if (UIEbits.SOFIE) {
+			PIR3bits.USBIF = 1;
+			ISRHigh();
+			}
+		}
+	
+	// Timer 2 period match
+	PIR1bits.TMR2IF = 1;
+	ISRLow();
+	
+	Run();
+	}
+}
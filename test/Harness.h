@@ -0,0 +1,52 @@
+/*
+	Harness
+	
+	The hardware around the firmware, for the host-side tests
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#pragma once
+
+
+/*	CHECK
+	Note a failure, with where it happened, if the condition doesn't hold
+*/
+#define CHECK(condition) Check((condition), #condition, __FILE__, __LINE__)
+
+extern void Check(bool, const char *, const char *, int);
+extern int Finish(void);
+
+
+/*	kShiftedIn
+	Marks SSP1BUF as holding a byte shifted in, rather than one to shift out
+	(see xc.h)
+*/
+enum { kShiftedIn = 0x100 };
+
+
+/*	Register hooks (see Registers.c)
+*/
+extern void (*gChipSelect)(bool);
+extern void (*gPingPongReset)(void);
+
+
+/*	gSPIDevice
+	What's on the other end of the SPI bus: takes the byte shifted out while
+	chip select is low, and gives the byte shifted in
+*/
+extern uint8_t (*gSPIDevice)(uint8_t);
+
+
+/*	Firmware entry points otherwise only reached through the hardware
+*/
+extern void ISRHigh(void);
+extern void ISRLow(void);
+
+
+extern uint32_t gMicroseconds;
+
+extern void Run(void);
+extern void Start(void);
+extern void Tick(uint16_t);
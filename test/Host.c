@@ -0,0 +1,452 @@
+/*
+	Host
+	
+	The USB host, and the SIE between it and the firmware, for the host-side
+	tests
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+ 	References:
+		[USB] Universal Serial Bus Specification, Revision 2.0
+		[PIC] Microchip PIC18(L)F2X/45K50 Data Sheet
+	
+	The SIE end: a transaction goes to the buffer descriptor the SIE is
+	pointing at for the endpoint and direction (even or odd on Endpoint 1;
+	see gPingPong).  The SIE NAKs if the firmware doesn't own that buffer
+	descriptor, and STALLs if it is set to.  With data toggle synchronization
+	enabled, a DATA0/1 that doesn't match the buffer descriptor's DTS is
+	ACKed but ignored: the buffer descriptor stays armed, and nothing
+	interrupts [PIC: Buffer Descriptor Status Register].  Otherwise the
+	transaction completes: the buffer descriptor comes back to the firmware,
+	USTAT says which one it was, and TRNIF interrupts.
+	
+	The host end: control transfers with their Setup, Data and Status
+	Stages [USB §8.5.3]; and single transactions on Endpoint 1, with the
+	host's side of the data toggles [USB §8.6].
+*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <xc.h>
+
+#include "USB.h"
+#include "Harness.h"
+#include "Host.h"
+
+
+enum {
+	kPIDOUT = 0b0001,
+	kPIDIN = 0b1001,
+	kPIDSETUP = 0b1101
+	};
+
+
+/*	kEndpoint0MaximumPacketLength
+	As in the device descriptor
+*/
+enum { kEndpoint0MaximumPacketLength = 32 };
+
+
+/*	kNAKRetries
+	How often the host tries again after a NAK
+	
+	All the firmware's work is done (see Run) by the time the host retries;
+	so a second NAK already means the firmware isn't going to arm the buffer
+	descriptor.
+*/
+enum { kNAKRetries = 3 };
+
+
+bool gHostToggleOUT1, gHostToggleIN1;
+unsigned gHostINDropped;
+uint16_t gHostControlReceived;
+
+
+/*	gPingPong
+	The buffer descriptor the SIE uses for the next Endpoint 1 OUT and IN
+	transactions
+*/
+static uint8_t gPingPongOUT1, gPingPongIN1;
+
+
+/*	PingPongReset
+	UCON.PPBRST
+*/
+static void PingPongReset()
+{
+gPingPongOUT1 = 0;
+gPingPongIN1 = 0;
+}
+
+
+/*	Complete
+	The SIE gives the buffer descriptor back to the firmware, and interrupts
+*/
+static void Complete(
+	volatile BufferDescriptor *bd,
+	uint8_t		pid,
+	uint8_t		endpoint,
+	bool		in,
+	uint8_t		pingPong
+	)
+{
+bd->STAT.i = 0;
+bd->STAT.PID = pid;
+
+USTATbits.ENDP = endpoint;
+USTATbits.DIR = in;
+USTATbits.PPBI = pingPong;
+
+UIRbits.TRNIF = 1;
+if (UIEbits.TRNIE) {
+	PIR3bits.USBIF = 1;
+	ISRHigh();
+	}
+
+Run();
+}
+
+
+/*	Receive
+	The SIE end of a SETUP or OUT transaction
+*/
+static HostResult Receive(
+	uint8_t		endpoint,
+	uint8_t		pid,
+	bool		toggle,
+	const uint8_t	*data,
+	uint8_t		dataL
+	)
+{
+const bool enabled = endpoint == 0 ? UEP0bits.EPOUTEN : UEP1bits.EPOUTEN;
+if (!enabled) return kHostTimeout;
+
+// after a SETUP, the SIE holds off until the firmware clears PKTDIS
+/* A SETUP itself can't be refused [USB §8.5.3]. */
+if (UCONbits.PKTDIS && pid != kPIDSETUP) return kHostNAK;
+
+const uint8_t pingPong = endpoint == 0 ? 0 : gPingPongOUT1;
+volatile BufferDescriptor *const bd = endpoint == 0 ? &ep0Out : &ep1Out[pingPong];
+
+if (!bd->STAT.UOWN) return kHostNAK;
+if (bd->STAT.BSTALL) return kHostSTALL;
+
+// the wrong toggle: a retry of a packet already received
+if (bd->STAT.DTSEN && bd->STAT.DTS != toggle) return kHostACK;
+
+// more than the buffer holds
+CHECK(dataL <= bd->CNT);
+
+if (dataL) memcpy((uint8_t*) bd->ADR, data, dataL);
+bd->CNT = dataL;
+
+if (endpoint == 1) gPingPongOUT1 ^= 1;
+if (pid == kPIDSETUP) UCONbits.PKTDIS = 1;
+
+Complete(bd, pid, endpoint, false, pingPong);
+return kHostACK;
+}
+
+
+/*	Send
+	The SIE end of an IN transaction
+	
+	The data, its length, and its toggle, if ACKed
+*/
+static HostResult Send(
+	uint8_t		endpoint,
+	uint8_t		*data,
+	uint8_t		*dataL,
+	bool		*toggle
+	)
+{
+const bool enabled = endpoint == 0 ? UEP0bits.EPINEN : UEP1bits.EPINEN;
+if (!enabled) return kHostTimeout;
+
+if (UCONbits.PKTDIS) return kHostNAK;
+
+const uint8_t pingPong = endpoint == 0 ? 0 : gPingPongIN1;
+volatile BufferDescriptor *const bd = endpoint == 0 ? &ep0In : &ep1In[pingPong];
+
+if (!bd->STAT.UOWN) return kHostNAK;
+
+if (bd->STAT.BSTALL) {
+	UIRbits.STALLIF = 1;
+	return kHostSTALL;
+	}
+
+*dataL = bd->CNT;
+memcpy(data, (const uint8_t*) bd->ADR, bd->CNT);
+*toggle = bd->STAT.DTS;
+
+if (endpoint == 1) gPingPongIN1 ^= 1;
+
+Complete(bd, kPIDIN, endpoint, true, pingPong);
+return kHostACK;
+}
+
+
+/*	OUT, IN
+	A transaction; tried again while the device NAKs
+*/
+static HostResult OUT(
+	uint8_t		endpoint,
+	uint8_t		pid,
+	bool		toggle,
+	const uint8_t	*data,
+	uint8_t		dataL
+	)
+{
+HostResult result = kHostNAK;
+for (uint8_t t = 0; t < kNAKRetries && result == kHostNAK; t++)
+	result = Receive(endpoint, pid, toggle, data, dataL);
+
+return result;
+}
+
+
+static HostResult IN(
+	uint8_t		endpoint,
+	uint8_t		*data,
+	uint8_t		*dataL,
+	bool		*toggle
+	)
+{
+HostResult result = kHostNAK;
+for (uint8_t t = 0; t < kNAKRetries && result == kHostNAK; t++)
+	result = Send(endpoint, data, dataL, toggle);
+
+return result;
+}
+
+
+/*	HostAttach
+	Have the SIE follow UCON.PPBRST
+*/
+void HostAttach()
+{
+gPingPongReset = PingPongReset;
+}
+
+
+/*	HostControl
+	A control transfer on Endpoint 0 [USB §8.5.3]: its Setup Stage, its Data
+	Stage (IN or OUT, according to bmRequestType, of wLength bytes), and its
+	Status Stage
+	
+	For IN, the data received goes in the given buffer, which must hold
+	wLength bytes; a short packet ends the Data Stage early.
+*/
+HostResult HostControl(
+	uint8_t		bmRequestType,
+	uint8_t		bRequest,
+	uint16_t	wValue,
+	uint16_t	wIndex,
+	uint16_t	wLength,
+	uint8_t		*data
+	)
+{
+return HostControlData(bmRequestType, bRequest, wValue, wIndex, wLength, data, wLength);
+}
+
+
+/*	HostControlData
+	A control transfer as HostControl, but with a Data Stage of the given
+	length, whatever wLength says; as a misbehaving host might
+*/
+HostResult HostControlData(
+	uint8_t		bmRequestType,
+	uint8_t		bRequest,
+	uint16_t	wValue,
+	uint16_t	wIndex,
+	uint16_t	wLength,
+	uint8_t		*data,
+	uint16_t	dataL
+	)
+{
+const uint8_t setup[8] = {
+	bmRequestType, bRequest,
+	(uint8_t) wValue, (uint8_t) (wValue >> 8),
+	(uint8_t) wIndex, (uint8_t) (wIndex >> 8),
+	(uint8_t) wLength, (uint8_t) (wLength >> 8)
+	};
+
+HostResult result = OUT(0, kPIDSETUP, 0, setup, sizeof setup);
+if (result != kHostACK) return result;
+
+const bool in = bmRequestType & 0x80;
+bool toggle = 1;
+
+// Data Stage
+uint16_t done = 0;
+gHostControlReceived = 0;
+while (done < dataL) {
+	uint8_t packet[kEndpoint0MaximumPacketLength], packetL;
+	
+	if (in) {
+		bool packetToggle;
+		result = IN(0, packet, &packetL, &packetToggle);
+		if (result != kHostACK) return result;
+		
+		CHECK(packetToggle == toggle);
+		CHECK(done + packetL <= dataL);
+		memcpy(data + done, packet, packetL);
+		}
+	
+	else {
+		packetL = dataL - done < sizeof packet ? dataL - done : sizeof packet;
+		result = OUT(0, kPIDOUT, toggle, data + done, packetL);
+		if (result != kHostACK) return result;
+		}
+	
+	done += packetL;
+	toggle = !toggle;
+	if (in) gHostControlReceived = done;
+	
+	// short packet?
+	if (packetL < kEndpoint0MaximumPacketLength) break;
+	}
+
+// Status Stage: a zero-length DATA1 packet the other way
+if (in)
+	return OUT(0, kPIDOUT, 1, NULL, 0);
+
+uint8_t status[kEndpoint0MaximumPacketLength], statusL;
+bool statusToggle;
+result = IN(0, status, &statusL, &statusToggle);
+if (result == kHostACK) {
+	CHECK(statusL == 0);
+	CHECK(statusToggle == 1);
+	}
+
+return result;
+}
+
+
+/*	HostConfigure
+	Enumerate the device as a host does, as far as selecting its one
+	configuration and reading its report descriptor [USB §9.1.2]
+	
+	The descriptors longer than an Endpoint 0 packet take more than one IN
+	transaction; HostControlData checks their toggles.
+*/
+void HostConfigure()
+{
+uint8_t descriptor[256];
+
+// the device descriptor, at the default address; asking for more than there
+// is, as hosts do, so that a short packet ends the Data Stage [USB §9.4.3]
+CHECK(HostControl(0x80, kGetDescriptor, kDevice << 8, 0, 64, descriptor) == kHostACK);
+CHECK(gHostControlReceived == 18);
+CHECK(descriptor[0] == 18 && descriptor[1] == kDevice);
+CHECK(descriptor[7] == kEndpoint0MaximumPacketLength);
+
+CHECK(HostControl(0x00, kSetAddress, 1, 0, 0, NULL) == kHostACK);
+CHECK(UADDR == 1);
+
+// the configuration descriptor: its first 9 bytes for wTotalLength; then all
+// of it, with the interface, HID and endpoint descriptors [USB §9.4.3]
+CHECK(HostControl(0x80, kGetDescriptor, kConfiguration << 8, 0, 9, descriptor) == kHostACK);
+CHECK(gHostControlReceived == 9);
+CHECK(descriptor[0] == 9 && descriptor[1] == kConfiguration);
+const uint16_t configurationL = descriptor[2] | descriptor[3] << 8;
+CHECK(configurationL == 9 + 9 + 9 + 7 + 7);
+
+CHECK(HostControl(0x80, kGetDescriptor, kConfiguration << 8, 0, configurationL, descriptor) == kHostACK);
+CHECK(gHostControlReceived == configurationL);
+
+// the HID descriptor, following the interface descriptor [HID §7.1]: the
+// length of the report descriptor
+const uint8_t *const hid = descriptor + 9 + 9;
+CHECK(hid[0] == 9 && hid[1] == kHID);
+CHECK(hid[5] == 1 && hid[6] == kHIDReport);
+const uint16_t reportL = hid[7] | hid[8] << 8;
+CHECK(reportL > kEndpoint0MaximumPacketLength && reportL <= sizeof descriptor);
+
+CHECK(HostControl(0x81, kGetDescriptor, kHIDReport << 8, 0, reportL, descriptor) == kHostACK);
+CHECK(gHostControlReceived == reportL);
+CHECK(descriptor[reportL - 1] == 0xC0);		// End Collection [HID §6.2.2.4]
+
+CHECK(HostControl(0x00, kSetConfiguration, 1, 0, 0, NULL) == kHostACK);
+
+// [USB §8.5.4] configuration starts interrupt endpoints at DATA0
+gHostToggleOUT1 = 0;
+gHostToggleIN1 = 0;
+}
+
+
+/*	HostClearHalt
+	CLEAR_FEATURE(ENDPOINT_HALT) for the given endpoint address (0x01 for
+	Endpoint 1 OUT, 0x81 for IN); after which the host starts that direction
+	over at DATA0 [USB §9.4.5]
+*/
+HostResult HostClearHalt(
+	uint8_t		endpoint
+	)
+{
+const HostResult result = HostControl(0x02, kClearFeature, 0, endpoint, 0, NULL);
+
+if (result == kHostACK) {
+	if (endpoint == 0x01) gHostToggleOUT1 = 0;
+	if (endpoint == 0x81) gHostToggleIN1 = 0;
+	}
+
+return result;
+}
+
+
+/*	HostOUT1
+	Send the given packet to Endpoint 1, with the next data toggle
+*/
+HostResult HostOUT1(
+	const uint8_t	*data,
+	uint8_t		dataL
+	)
+{
+const HostResult result = HostOUT1Toggle(data, dataL, gHostToggleOUT1);
+
+if (result == kHostACK) gHostToggleOUT1 = !gHostToggleOUT1;
+
+return result;
+}
+
+
+/*	HostOUT1Toggle
+	Send the given packet to Endpoint 1 with the given data toggle, without
+	advancing the host's; e.g., as the retry of a packet whose ACK got lost
+*/
+HostResult HostOUT1Toggle(
+	const uint8_t	*data,
+	uint8_t		dataL,
+	bool		toggle
+	)
+{
+return OUT(1, kPIDOUT, toggle, data, dataL);
+}
+
+
+/*	HostIN1
+	Collect a packet from Endpoint 1
+	
+	One with the wrong data toggle is ACKed but discarded (counted in
+	gHostINDropped), and the result is NAK.
+*/
+HostResult HostIN1(
+	uint8_t		*data,
+	uint8_t		*dataL
+	)
+{
+bool toggle;
+const HostResult result = IN(1, data, dataL, &toggle);
+if (result != kHostACK) return result;
+
+if (toggle != gHostToggleIN1) {
+	gHostINDropped++;
+	return kHostNAK;
+	}
+
+gHostToggleIN1 = !gHostToggleIN1;
+return kHostACK;
+}
@@ -0,0 +1,53 @@
+/*
+	Host
+	
+	The USB host, and the SIE between it and the firmware, for the host-side
+	tests
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#pragma once
+
+
+/*	HostResult
+	How the device responded to a transaction; or for a transfer, to the
+	transaction that ended it
+*/
+typedef enum {
+	kHostACK,
+	kHostNAK,
+	kHostSTALL,
+	kHostTimeout				// no response: the endpoint isn't enabled
+	} HostResult;
+
+
+/*	gHostToggle
+	The data toggle the host uses (OUT) or expects (IN) next on Endpoint 1;
+	reset to DATA0 by configuration, and by clearing the endpoint's Halt
+*/
+extern bool gHostToggleOUT1, gHostToggleIN1;
+
+
+/*	gHostINDropped
+	IN packets the host discarded because they had the wrong data toggle
+	(i.e., that it took for retries of a packet it already had)
+*/
+extern unsigned gHostINDropped;
+
+
+/*	gHostControlReceived
+	The bytes received in the Data Stage of the last control read
+*/
+extern uint16_t gHostControlReceived;
+
+
+extern void HostAttach(void);
+extern HostResult HostClearHalt(uint8_t);
+extern void HostConfigure(void);
+extern HostResult HostControl(uint8_t, uint8_t, uint16_t, uint16_t, uint16_t, uint8_t *);
+extern HostResult HostControlData(uint8_t, uint8_t, uint16_t, uint16_t, uint16_t, uint8_t *, uint16_t);
+extern HostResult HostIN1(uint8_t *, uint8_t *);
+extern HostResult HostOUT1(const uint8_t *, uint8_t);
+extern HostResult HostOUT1Toggle(const uint8_t *, uint8_t, bool);
@@ -0,0 +1,228 @@
+/*
+	MAX6954
+	
+	Model of the MAX6954 display driver and key scanner on the SPI bus, for
+	the host-side tests
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+ 	References:
+		[MAX] MAX6954 4-Wire Interfaced, 2.7V to 5.5V LED Display Driver
+			with I/O Expander and Key Scan
+	
+	Only as much of the device as the firmware uses: the registers; 16-bit
+	commands, executed when chip select goes high; reads, whose data is
+	shifted out during the next command; hexadecimal decoding of the digits;
+	and the debounced keys, with IRQ (on RB2).
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Harness.h"
+#include "MAX6954.h"
+
+
+enum {
+	kRegisterKeyAMaskDebounce = 0x08,
+	kRegisterDigit0Plane0 = 0x20,
+	kRegisterDigit0APlane0 = 0x28
+	};
+
+
+uint8_t gMAXRegisters[0x80];
+unsigned gMAXCommands, gMAXFramingErrors;
+
+
+/*	gShift
+	The command being shifted in since chip select went low, and how many
+	bits of it; and what is being shifted out
+*/
+static uint16_t gShiftIn, gShiftOut;
+static uint8_t gShiftBits;
+static bool gSelected;
+
+
+/*	gOutput
+	What the next command shifts out: the previous command; so after a read,
+	the data in the low byte [MAX: Reading Device Registers]
+*/
+static uint16_t gOutput;
+
+
+/*	gKeysDown
+	Keys held down; and those that went down since their Key Debounced
+	register was last read (which keep IRQ low) [MAX: Key Scanning]
+*/
+static uint32_t gKeysDown, gKeysPressed;
+
+
+/*	SetIRQ
+	IRQ is low (active) while there are key presses not read yet
+*/
+static void SetIRQ()
+{
+const bool high = gKeysPressed == 0;
+
+if (PORTBbits.RB2 == high) return;
+PORTBbits.RB2 = high;
+
+// falling edge on INT2
+if (!high && !INTCON2bits.INTEDG2) {
+	INTCON3bits.INT2IF = 1;
+	if (INTCON3bits.INT2IE && INTCONbits.GIEL) {
+		ISRLow();
+		Run();
+		}
+	}
+}
+
+
+/*	Execute
+	Carry out a whole command
+*/
+static void Execute(
+	uint16_t	command
+	)
+{
+const uint8_t address = (command >> 8) & 0x7F;
+uint8_t data = (uint8_t) command;
+
+gMAXCommands++;
+
+// read?
+if (command & 0x8000) {
+	data = gMAXRegisters[address];
+	
+	// Key Debounced registers
+	/* The keys pressed since the previous read, and those still down */
+	if (address >= kRegisterKeyAMaskDebounce && address < kRegisterKeyAMaskDebounce + 4) {
+		const uint8_t shift = 8 * (address - kRegisterKeyAMaskDebounce);
+		data = (uint8_t) ((gKeysPressed | gKeysDown) >> shift);
+		gKeysPressed &= ~((uint32_t) 0xFF << shift);
+		SetIRQ();
+		}
+	}
+
+else
+	gMAXRegisters[address] = data;
+
+gOutput = (uint16_t) (command & 0xFF00) | data;
+}
+
+
+/*	ChipSelect
+*/
+static void ChipSelect(
+	bool		high
+	)
+{
+// starting a command?
+if (!high) {
+	gShiftBits = 0;
+	gShiftIn = 0;
+	gShiftOut = gOutput;
+	}
+
+// (only going high from low ends one)
+else if (!gSelected)
+	;
+
+// whole command?
+else if (gShiftBits == 16)
+	Execute(gShiftIn);
+
+else
+	gMAXFramingErrors++;
+
+gSelected = !high;
+}
+
+
+/*	Shift
+	A byte while chip select is low
+*/
+static uint8_t Shift(
+	uint8_t		in
+	)
+{
+const uint8_t out = (uint8_t) (gShiftOut >> 8);
+
+gShiftIn = (uint16_t) (gShiftIn << 8) | in;
+gShiftOut <<= 8;
+
+// more than a command's worth is a framing error when CS goes high
+if (gShiftBits < 255 - 8) gShiftBits += 8;
+
+return out;
+}
+
+
+/*	MAXAttach
+	Put the MAX on the SPI bus, with no keys down
+*/
+void MAXAttach()
+{
+gSPIDevice = Shift;
+gChipSelect = ChipSelect;
+
+PORTBbits.RB2 = 1;
+}
+
+
+/*	MAXPress
+	The given keys go down
+	
+	Key n is bit n: key n % 8 of key line n / 8.
+*/
+void MAXPress(
+	uint32_t	keys
+	)
+{
+gKeysDown |= keys;
+
+// only keys enabled in the Key Mask registers interrupt
+uint32_t masked;
+((uint8_t*) &masked)[0] = gMAXRegisters[kRegisterKeyAMaskDebounce + 0];
+((uint8_t*) &masked)[1] = gMAXRegisters[kRegisterKeyAMaskDebounce + 1];
+((uint8_t*) &masked)[2] = gMAXRegisters[kRegisterKeyAMaskDebounce + 2];
+((uint8_t*) &masked)[3] = gMAXRegisters[kRegisterKeyAMaskDebounce + 3];
+gKeysPressed |= keys & masked;
+
+SetIRQ();
+}
+
+
+/*	MAXRelease
+	The given keys come up
+*/
+void MAXRelease(
+	uint32_t	keys
+	)
+{
+gKeysDown &= ~keys;
+}
+
+
+/*	MAXDisplay
+	What the given display (0: digits 0 through 5; 1: 0a through 5a) shows,
+	as a string; with hexadecimal decoding, and the decimal points
+*/
+void MAXDisplay(
+	uint8_t		display,
+	char		text[8]
+	)
+{
+const uint8_t first = display ? kRegisterDigit0APlane0 : kRegisterDigit0Plane0;
+
+uint8_t t = 0;
+for (uint8_t d = 0; d < 6; d++) {
+	const uint8_t digit = gMAXRegisters[first + d];
+	text[t++] = "0123456789ABCDEF"[digit & 0x0F];
+	if (digit & 0x80) text[t++] = '.';
+	}
+
+text[t] = '\0';
+}
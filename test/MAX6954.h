@@ -0,0 +1,30 @@
+/*
+	MAX6954
+	
+	Model of the MAX6954 display driver and key scanner on the SPI bus, for
+	the host-side tests
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#pragma once
+
+
+/*	gMAXRegisters
+	The registers, as written by (or for reads, as given to) the firmware
+*/
+extern uint8_t gMAXRegisters[0x80];
+
+
+/*	gMAXCommands
+	16-bit commands executed; and those that weren't, because chip select
+	went high after some other number of bits
+*/
+extern unsigned gMAXCommands, gMAXFramingErrors;
+
+
+extern void MAXAttach(void);
+extern void MAXDisplay(uint8_t, char [8]);
+extern void MAXPress(uint32_t);
+extern void MAXRelease(uint32_t);
@@ -0,0 +1,68 @@
+/*
+	Registers
+	
+	PIC18F45K50 register model (see xc.h)
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+ 	References:
+		[PIC] Microchip PIC18(L)F2X/45K50 Data Sheet
+*/
+
+#define REGISTERS_DEFINE
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Harness.h"
+
+
+/*	gChipSelect
+	Called when an access to LATA finds that chip select (LATA5) changed since
+	the previous access
+*/
+void (*gChipSelect)(bool) = NULL;
+
+
+/*	LATAAccess
+*/
+volatile LATA_bits_t *LATAAccess()
+{
+static bool high;			// as the latch, before anything is written
+
+if (LATA_bits.LATA5 != high) {
+	high = LATA_bits.LATA5;
+	if (gChipSelect) (*gChipSelect)(high);
+	}
+
+return &LATA_bits;
+}
+
+
+/*	gPingPongReset
+	Called when an access to UCON finds that PPBRST was set since the previous
+	access
+*/
+void (*gPingPongReset)(void) = NULL;
+
+
+/*	UCONAccess
+*/
+volatile UCON_bits_t *UCONAccess()
+{
+if (UCON_bits.PPBRST && gPingPongReset) (*gPingPongReset)();
+
+return &UCON_bits;
+}
+
+
+/*	PIR1Access
+*/
+volatile PIR1_bits_t *PIR1Access()
+{
+if (T2CONbits.TMR2ON && !PIE1bits.TMR2IE) PIR1_bits.TMR2IF = 1;
+
+return &PIR1_bits;
+}
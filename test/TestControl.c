@@ -0,0 +1,109 @@
+/*
+	TestControl
+	
+	Class requests on the control endpoint: those that succeed, and those
+	that have to STALL
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Counters.h"
+#include "Display.h"
+#include "Timer1.h"
+#include "USB.h"
+#include "USBEndpoint1.h"
+#include "Harness.h"
+#include "Host.h"
+#include "MAX6954.h"
+
+
+enum {
+	kToDeviceClassInterface = 0b00100001,
+	kToHostClassInterface = 0b10100001
+	};
+
+
+/*	Refused
+	Whether the transfer got a STALL and an Error(); forgets the Error()
+*/
+static bool Refused(
+	HostResult	result
+	)
+{
+const bool refused = result == kHostSTALL && gCounters.errors == 1;
+gCounters.errors = 0;
+return refused;
+}
+
+
+int main()
+{
+MAXAttach();
+HostAttach();
+Start();
+HostConfigure();
+
+// SetReport (Output) with the values
+uint8_t report[8] = { kReportIDValues, 0x40, 0xE2, 0x01, 0x00, 0x00, 0xFF, 0xFF };
+CHECK(HostControl(kToDeviceClassInterface, kSetReport, kReportOutput << 8 | kReportIDValues, 0, kValuesReportLength, report) == kHostACK);
+CHECK(gValue0 == 123456 && gValue1 == 0);
+CHECK(gCounters.reportsReceived == 1);
+
+// SetReport of a report we don't take
+CHECK(Refused(HostControl(kToDeviceClassInterface, kSetReport, kReportOutput << 8 | kReportIDPanel, 0, kValuesReportLength, report)));
+
+// of the wrong length
+CHECK(Refused(HostControl(kToDeviceClassInterface, kSetReport, kReportOutput << 8 | kReportIDValues, 0, 4, report)));
+
+// more data than wLength
+report[1] = 0x41;
+CHECK(Refused(HostControlData(kToDeviceClassInterface, kSetReport, kReportOutput << 8 | kReportIDValues, 0, kValuesReportLength, report, sizeof report)));
+CHECK(gValue0 == 123456);
+
+// less
+CHECK(Refused(HostControlData(kToDeviceClassInterface, kSetReport, kReportOutput << 8 | kReportIDValues, 0, kValuesReportLength, report, 4)));
+CHECK(gValue0 == 123456);
+
+// data that isn't the report the SETUP announced
+report[0] = kReportIDPanel;
+CHECK(Refused(HostControl(kToDeviceClassInterface, kSetReport, kReportOutput << 8 | kReportIDValues, 0, kValuesReportLength, report)));
+CHECK(gValue0 == 123456);
+report[0] = kReportIDValues;
+
+// none of which count as received
+CHECK(gCounters.reportsReceived == 1);
+
+// SetIdle, for all reports
+uint8_t idle = 0;
+CHECK(HostControl(kToDeviceClassInterface, kSetIdle, 5 << 8, 0, 0, NULL) == kHostACK);
+CHECK(HostControl(kToHostClassInterface, kGetIdle, 0, 0, 1, &idle) == kHostACK);
+CHECK(idle == 5);
+
+// for the Input report: the same idle rate
+CHECK(HostControl(kToDeviceClassInterface, kSetIdle, 7 << 8 | kReportIDValues, 0, 0, NULL) == kHostACK);
+CHECK(HostControl(kToHostClassInterface, kGetIdle, kReportIDValues, 0, 1, &idle) == kHostACK);
+CHECK(idle == 7);
+CHECK(GetIdleRate() == 7);
+
+// for a report that isn't an Input report: STALLed, but not an error of ours
+CHECK(HostControl(kToDeviceClassInterface, kSetIdle, 9 << 8 | kReportIDPanel, 0, 0, NULL) == kHostSTALL);
+CHECK(HostControl(kToHostClassInterface, kGetIdle, kReportIDCounters, 0, 1, &idle) == kHostSTALL);
+CHECK(GetIdleRate() == 7);
+CHECK(gCounters.errors == 0);
+
+// SetProtocol: only for boot devices [HID §7.2.6]
+CHECK(Refused(HostControl(kToDeviceClassInterface, kSetProtocol, 0, 0, 0, NULL)));
+
+// and after all that, a request that succeeds
+report[1] = 0x42;
+CHECK(HostControl(kToDeviceClassInterface, kSetReport, kReportFeature << 8 | kReportIDValues, 0, kValuesReportLength, report) == kHostACK);
+CHECK(gValue0 == 123458);
+CHECK(gCounters.reportsReceived == 2);
+
+return Finish();
+}
@@ -0,0 +1,70 @@
+/*
+	TestDecimal
+	
+	Every value a report can hold, as the MAX6954 displays it
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <xc.h>
+
+#include "Display.h"
+#include "Harness.h"
+#include "MAX6954.h"
+
+
+/*	kValueMaximum
+	The largest 20-bit value
+*/
+enum { kValueMaximum = 0xFFFFF };
+
+
+/*	Shows
+	Whether the given display shows the given value: six decimal digits, the
+	decimal point after the third; and 'A' for a most significant digit of 10
+*/
+static bool Shows(
+	uint8_t		display,
+	uint32_t	value
+	)
+{
+char expected[9], shown[8];
+snprintf(expected, sizeof expected, "%c%02u.%03u",
+	"0123456789A"[value / 100000], value / 1000 % 100, value % 1000);
+
+MAXDisplay(display, shown);
+return strcmp(shown, expected) == 0;
+}
+
+
+int main()
+{
+MAXAttach();
+Start();
+DisplayInitialize();
+Run();
+
+// each value on one display, and its complement on the other
+unsigned failures = 0;
+for (uint32_t v = 0; v <= kValueMaximum; v++) {
+	DisplayValues(v, kValueMaximum - v);
+	Run();
+	
+	// only the first few failures get reported
+	if (!Shows(0, v) || !Shows(1, kValueMaximum - v))
+		if (failures++ < 10) {
+			CHECK(Shows(0, v));
+			CHECK(Shows(1, kValueMaximum - v));
+			}
+	}
+
+CHECK(failures == 0);
+CHECK(gMAXFramingErrors == 0);
+
+return Finish();
+}
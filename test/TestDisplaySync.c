@@ -0,0 +1,95 @@
+/*
+	TestDisplaySync
+	
+	Frames of digits sent on the Start-of-Frame (DISPLAY_SYNC_FRAMES), and
+	updates that arrive while one waits
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <xc.h>
+
+#include "Display.h"
+#include "Harness.h"
+#include "MAX6954.h"
+
+
+/*	DisplayIs
+	Whether the given display shows the given text
+*/
+static bool DisplayIs(
+	uint8_t		display,
+	const char	*text
+	)
+{
+char shown[8];
+MAXDisplay(display, shown);
+return strcmp(shown, text) == 0;
+}
+
+
+/*	Synchronize
+	Let frames pass until the frame number is one to send on
+*/
+static void Synchronize()
+{
+while (UFRML % DISPLAY_SYNC_FRAMES != DISPLAY_SYNC_FRAMES - 1) Tick(1);
+}
+
+
+int main()
+{
+MAXAttach();
+Start();
+DisplayInitialize();
+Run();
+
+// nothing until the Start-of-Frame
+Synchronize();
+DisplayValues(123456, 654321);
+Run();
+CHECK(DisplayIs(0, "000000"));
+Tick(1);
+CHECK(DisplayIs(0, "123.456"));
+CHECK(DisplayIs(1, "654.321"));
+
+// updates while the frame waits: the latest go out with it
+Synchronize();
+DisplayValues(111111, 654321);
+DisplayValues(111111, 999999);
+DisplayValues(777777, 999999);
+Run();
+CHECK(DisplayIs(0, "123.456"));
+unsigned commands = gMAXCommands;
+Tick(1);
+CHECK(DisplayIs(0, "777.777"));
+CHECK(DisplayIs(1, "999.999"));
+
+// in one frame, with each digit once
+CHECK(gMAXCommands - commands == 12);
+
+// a digit changed and changed back before the frame went out
+Synchronize();
+DisplayValues(777778, 999999);
+DisplayValues(777777, 999999);
+Run();
+Tick(1);
+CHECK(DisplayIs(0, "777.777"));
+
+// intensity, with digits
+Synchronize();
+DisplayIntensity(9);
+DisplayValues(777777, 999998);
+Run();
+Tick(1);
+CHECK(gMAXRegisters[0x02] == 9);
+CHECK(DisplayIs(1, "999.998"));
+
+CHECK(gMAXFramingErrors == 0);
+
+return Finish();
+}
@@ -0,0 +1,223 @@
+/*
+	TestEndpoint1
+	
+	Endpoint 1 and its data toggles: OUT reports, retried packets, and
+	clearing the Halt feature in either direction
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <xc.h>
+
+#include "Counters.h"
+#include "Display.h"
+#include "Timer1.h"
+#include "USB.h"
+#include "USBEndpoint1.h"
+#include "Harness.h"
+#include "Host.h"
+#include "MAX6954.h"
+
+
+/*	ValuesReport
+	The values report for the given values (see PackValues)
+*/
+static void ValuesReport(
+	uint8_t		report[kValuesReportLength],
+	uint32_t	value0,
+	uint32_t	value1
+	)
+{
+const uint64_t values = value0 | (uint64_t) value1 << 20;
+
+report[0] = kReportIDValues;
+for (uint8_t b = 0; b < kValuesLength; b++)
+	report[1 + b] = (uint8_t) (values >> 8 * b);
+}
+
+
+/*	Send
+	Have the host send a values report, with the next data toggle
+*/
+static HostResult Send(
+	uint32_t	value0,
+	uint32_t	value1
+	)
+{
+uint8_t report[kValuesReportLength];
+ValuesReport(report, value0, value1);
+return HostOUT1(report, sizeof report);
+}
+
+
+/*	Displays
+	Whether the MAX6954 displays the given values
+*/
+static bool Displays(
+	uint32_t	value0,
+	uint32_t	value1
+	)
+{
+return gValue0 == value0 && gValue1 == value1;
+}
+
+
+/*	SendPanel
+	Have the host send a panel report of two values records and an intensity
+	record; or, if malformed, with the intensity record cut short
+*/
+static HostResult SendPanel(
+	uint32_t	first0,
+	uint32_t	first1,
+	uint32_t	value0,
+	uint32_t	value1,
+	uint8_t		intensity,
+	bool		malformed
+	)
+{
+uint8_t report[kPanelReportLength];
+uint8_t values[kValuesReportLength];
+uint8_t reportL = 0;
+
+report[reportL++] = kReportIDPanel;
+report[reportL++] = 3;
+
+report[reportL++] = kPanelRecordValues;
+ValuesReport(values, first0, first1);
+memcpy(report + reportL, values + 1, kValuesLength);
+reportL += kValuesLength;
+
+report[reportL++] = kPanelRecordValues;
+ValuesReport(values, value0, value1);
+memcpy(report + reportL, values + 1, kValuesLength);
+reportL += kValuesLength;
+
+report[reportL++] = kPanelRecordIntensity;
+if (!malformed)
+	report[reportL++] = intensity;
+
+return HostOUT1(report, reportL);
+}
+
+
+/*	Collect
+	Have the host collect an Input report; its keys
+*/
+static uint32_t Collect()
+{
+uint8_t report[kInputReportLength];
+uint8_t reportL = 0;
+uint32_t keys = 0xFFFFFFFF;
+
+if (HostIN1(report, &reportL) == kHostACK && reportL == kInputReportLength)
+	memcpy(&keys, report + kValuesReportLength, sizeof keys);
+
+return keys;
+}
+
+
+int main()
+{
+MAXAttach();
+HostAttach();
+Start();
+HostConfigure();
+
+// alternating DATA0, DATA1 in the even, odd buffer descriptors
+const uint16_t received = gCounters.reportsReceived;
+CHECK(Send(100000, 200000) == kHostACK);
+CHECK(Displays(100000, 200000));
+CHECK(Send(100001, 200001) == kHostACK);
+CHECK(Displays(100001, 200001));
+CHECK(Send(100002, 200002) == kHostACK);
+CHECK(Displays(100002, 200002));
+CHECK(gCounters.reportsReceived - received == 3);
+
+// a retry (the host missed our ACK) is ACKed, but not handled again
+uint8_t report[kValuesReportLength];
+ValuesReport(report, 100003, 200003);
+CHECK(HostOUT1Toggle(report, sizeof report, !gHostToggleOUT1) == kHostACK);
+CHECK(Displays(100002, 200002));
+CHECK(gCounters.reportsReceived - received == 3);
+
+// clearing the OUT Halt with the SIE on the odd buffer descriptor: the host
+// starts over at DATA0, and so must the SIE
+CHECK(gHostToggleOUT1 == 1);
+CHECK(HostClearHalt(0x01) == kHostACK);
+CHECK(Send(100004, 200004) == kHostACK);
+CHECK(Displays(100004, 200004));
+CHECK(Send(100005, 200005) == kHostACK);
+CHECK(Displays(100005, 200005));
+CHECK(Send(100006, 200006) == kHostACK);
+CHECK(Displays(100006, 200006));
+
+// and again from the even buffer descriptor
+CHECK(HostClearHalt(0x01) == kHostACK);
+CHECK(Send(100007, 200007) == kHostACK);
+CHECK(Displays(100007, 200007));
+
+// a key press: its report, and a follow-up without it, both waiting in the
+// IN buffer descriptors (and time for the scan to see the key come up)
+const uint32_t key = 1ul << 12;
+MAXPress(key);
+MAXRelease(key);
+Tick(100);
+CHECK(ep1In[0].STAT.UOWN && ep1In[1].STAT.UOWN);
+
+// clearing the IN Halt: the reports go out in order, starting at DATA0
+CHECK(HostClearHalt(0x81) == kHostACK);
+CHECK(Collect() == key);
+CHECK(Collect() == 0);
+CHECK(gHostINDropped == 0);
+
+// clearing the OUT Halt with one report waiting: it keeps its toggle
+MAXPress(key);
+MAXRelease(key);
+Tick(100);
+CHECK(Collect() == key);
+CHECK(HostClearHalt(0x01) == kHostACK);
+CHECK(Collect() == 0);
+CHECK(gHostINDropped == 0);
+
+// and with two
+MAXPress(key);
+MAXRelease(key);
+Tick(100);
+CHECK(HostClearHalt(0x01) == kHostACK);
+CHECK(Collect() == key);
+CHECK(Collect() == 0);
+CHECK(gHostINDropped == 0);
+
+// OUT still in step after all that
+CHECK(Send(100008, 200008) == kHostACK);
+CHECK(Displays(100008, 200008));
+
+// a panel report: only its last values record reaches the display, in
+// as many commands as a values report of its own takes
+Tick(10);
+unsigned commands = gMAXCommands;
+CHECK(Send(333333, 444444) == kHostACK);
+Tick(10);
+const unsigned valuesCommands = gMAXCommands - commands;
+commands = gMAXCommands;
+CHECK(SendPanel(111111, 111111, 555555, 666666, 5, false) == kHostACK);
+Tick(10);
+CHECK(Displays(555555, 666666));
+CHECK(gMAXRegisters[0x02] == 5);
+CHECK(gMAXCommands - commands == valuesCommands + 1);
+CHECK(gCounters.errors == 0);
+
+// a malformed one isn't applied at all
+CHECK(SendPanel(777777, 888888, 777777, 888888, 9, true) == kHostACK);
+Tick(10);
+CHECK(Displays(555555, 666666));
+CHECK(gMAXRegisters[0x02] == 5);
+CHECK(gCounters.errors == 1);
+gCounters.errors = 0;
+
+return Finish();
+}
@@ -0,0 +1,129 @@
+/*
+	TestProfile
+	
+	The hot path statistics, and the Feature report the host reads them
+	through (see tools/Benchmark.c, which runs the same workload on the
+	panel itself)
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+	The µs clock here only advances with Tick; so the cycle counts are of no
+	interest, only which paths were timed and how often.
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Counters.h"
+#include "Profile.h"
+#include "Timer1.h"
+#include "USB.h"
+#include "USBEndpoint1.h"
+#include "Harness.h"
+#include "Host.h"
+#include "MAX6954.h"
+
+
+enum {
+	kToDeviceClassInterface = 0b00100001,
+	kToHostClassInterface = 0b10100001
+	};
+
+
+/*	kWorkload
+	Values reports on Endpoint 1, one every 10 ms; and every tenth, a read
+	of the values through the control pipe (as tools/Benchmark)
+*/
+enum {
+	kWorkloadReports = 1000,
+	kWorkloadReadEvery = 10
+	};
+
+
+/*	Count
+	The count of a path in a profile report
+*/
+static uint16_t Count(
+	const uint8_t	*report,
+	uint8_t		path
+	)
+{
+const uint8_t *const stats = report + 1 + path * sizeof (ProfileStats);
+return stats[8] | stats[9] << 8;
+}
+
+
+int main()
+{
+MAXAttach();
+HostAttach();
+Start();
+HostConfigure();
+
+// the clock read leaves the interrupts as it found them
+INTCONbits.GIEH = 1;
+Timer1Read();
+CHECK(INTCONbits.GIEH);
+INTCONbits.GIEH = 0;
+Timer1Read();
+CHECK(!INTCONbits.GIEH);
+INTCONbits.GIEH = 1;
+
+// reset: the report ID alone
+uint8_t report[kProfileReportLength] = { kReportIDProfile };
+CHECK(HostControl(kToDeviceClassInterface, kSetReport, kReportFeature << 8 | kReportIDProfile, 0, 1, report) == kHostACK);
+// (but for the interrupts of the Status Stage, which come after)
+CHECK(gProfile[kProfileDisplayValues].count == 0);
+CHECK(gProfile[kProfileEndpoint0SETUP].count == 0);
+CHECK(gProfile[kProfileSPIInterrupt].count == 0);
+
+// the workload
+for (unsigned r = 0; r < kWorkloadReports; r++) {
+	const uint32_t v = r % 10 * 111111;
+	const uint64_t values = v | (uint64_t) (999999 - v) << 20;
+	uint8_t out[kValuesReportLength] = { kReportIDValues };
+	for (uint8_t b = 0; b < kValuesLength; b++)
+		out[1 + b] = (uint8_t) (values >> 8 * b);
+	CHECK(HostOUT1(out, sizeof out) == kHostACK);
+	
+	if (r % kWorkloadReadEvery == 0) {
+		uint8_t in[kValuesReportLength];
+		CHECK(HostControl(kToHostClassInterface, kGetReport, kReportFeature << 8 | kReportIDValues, 0, sizeof in, in) == kHostACK);
+		}
+	
+	Tick(10);
+	}
+
+// the statistics, as the host reads them
+CHECK(HostControl(kToHostClassInterface, kGetReport, kReportFeature << 8 | kReportIDProfile, 0, sizeof report, report) == kHostACK);
+CHECK(report[0] == kReportIDProfile);
+CHECK(Count(report, kProfileDisplayValues) == kWorkloadReports);
+CHECK(Count(report, kProfileEndpoint0SETUP) == kWorkloadReports / kWorkloadReadEvery);
+CHECK(Count(report, kProfileUSBInterrupt) >= kWorkloadReports);
+CHECK(Count(report, kProfileSPIInterrupt) > 0);
+
+// the latencies: of every SPI byte, and every tick; all 0 here, where the
+// handlers run the moment their flags are set
+CHECK(Count(report, kProfileSPILatency) == Count(report, kProfileSPIInterrupt));
+CHECK(Count(report, kProfileTickLatency) == kWorkloadReports * 10);
+CHECK(gProfile[kProfileSPILatency].max == 0);
+CHECK(gProfile[kProfileTickLatency].max == 0);
+
+for (uint8_t p = 0; p < kProfileN; p++)
+	CHECK(gProfile[p].min <= gProfile[p].max);
+
+// a reset whose data isn't the report ID is refused, and resets nothing
+uint8_t other[1] = { kReportIDValues };
+CHECK(HostControl(kToDeviceClassInterface, kSetReport, kReportFeature << 8 | kReportIDProfile, 0, 1, other) == kHostSTALL);
+CHECK(gCounters.errors == 1);
+gCounters.errors = 0;
+CHECK(gProfile[kProfileDisplayValues].count == kWorkloadReports);
+
+// and reset again
+CHECK(HostControl(kToDeviceClassInterface, kSetReport, kReportFeature << 8 | kReportIDProfile, 0, 1, report) == kHostACK);
+CHECK(gProfile[kProfileDisplayValues].count == 0);
+
+return Finish();
+}
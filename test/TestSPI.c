@@ -0,0 +1,162 @@
+/*
+	TestSPI
+	
+	The SPI queue, and the MAX6954 on the other end of it: configuration,
+	digits, the chained key reads, and which exchanges write back
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <xc.h>
+
+#include "Counters.h"
+#include "Display.h"
+#include "SPI.h"
+#include "USB.h"
+#include "USBEndpoint1.h"
+#include "Harness.h"
+#include "MAX6954.h"
+
+
+static unsigned gCompleted;
+
+static void Completed() { gCompleted++; }
+
+
+/*	DisplayIs
+	Whether the given display shows the given text
+*/
+static bool DisplayIs(
+	uint8_t		display,
+	const char	*text
+	)
+{
+char shown[8];
+MAXDisplay(display, shown);
+return strcmp(shown, text) == 0;
+}
+
+
+/*	KeysReported
+	The keys in the Input report in the given Endpoint 1 IN buffer
+*/
+static uint32_t KeysReported(
+	uint8_t		pingPong
+	)
+{
+uint32_t keys;
+memcpy(&keys, (const uint8_t*) ep1InBuffer[pingPong] + kValuesReportLength, sizeof keys);
+return keys;
+}
+
+
+int main()
+{
+MAXAttach();
+Start();
+
+// configuration
+DisplayInitialize();
+Run();
+CHECK(gMAXRegisters[0x03] == 5);
+CHECK(gMAXRegisters[0x01] == 0xFF);
+CHECK(gMAXRegisters[0x04] == 0x01);
+CHECK(gMAXRegisters[0x06] == 0x80);
+CHECK(gMAXRegisters[0x08] == 0xFF && gMAXRegisters[0x0B] == 0xFF);
+CHECK(PORTBbits.RB2 == 1);
+
+// digits, with the decimal points
+DisplayValues(123456, 118000);
+Run();
+CHECK(DisplayIs(0, "123.456"));
+CHECK(DisplayIs(1, "118.000"));
+
+// only the digits that changed
+unsigned commands = gMAXCommands;
+DisplayValues(123457, 118000);
+Run();
+CHECK(DisplayIs(0, "123.457"));
+CHECK(gMAXCommands - commands == 1);
+
+// updates while a frame is on the bus: the latest wins
+DisplayValues(111111, 222222);
+DisplayValues(333333, 444444);
+DisplayValues(135790, 246800);
+Run();
+CHECK(DisplayIs(0, "135.790"));
+CHECK(DisplayIs(1, "246.800"));
+
+// chained key reads: keys on all four key lines, in one report
+/* Not keys A 0 and A 1, which also do something */
+const uint32_t keys = 1ul << 4 | 1ul << 9 | 1ul << 18 | 1ul << 31;
+MAXPress(keys);
+CHECK(PORTBbits.RB2 == 1);
+CHECK(KeysReported(0) == keys);
+
+// held down: polled, but not reported again
+MAXRelease(keys);
+Tick(100);
+CHECK(!(ep1In[1].STAT.UOWN && KeysReported(1)));
+
+// key A 0 swaps the values
+MAXPress(1);
+MAXRelease(1);
+CHECK(DisplayIs(0, "246.800"));
+CHECK(DisplayIs(1, "135.790"));
+
+// exchanges complete in order of submission
+static char first[] = { 0x02, 0x01 }, second[] = { 0x02, 0x02 }, third[] = { 0x02, 0x03 };
+SPIStartExchange(first, sizeof first, NULL);
+SPIStartExchange(second, sizeof second, NULL);
+SPIStartExchange(third, sizeof third, Completed);
+Run();
+CHECK(gMAXRegisters[0x02] == 3);
+CHECK(gCompleted == 1);
+
+// without a callback, the buffer stays as it was
+CHECK(first[0] == 0x02 && first[1] == 0x01);
+
+// with one, it holds what came back: the previous command
+CHECK(third[0] == 0x02 && third[1] == 0x02);
+
+// a read, and the No-Op that shifts out its data
+static char read[] = { 0x80 | 0x02, 0, 0x00, 0 };
+SPIStartExchange(read, sizeof read, Completed);
+Run();
+CHECK(read[3] == 3);
+
+// the host selecting and deselecting the configuration faster than the MAX
+// can be configured: only the latest waits, behind a frame of digits
+DisplayValues(111111, 222222);
+for (uint8_t n = 0; n < 10; n++) {
+	DisplayTerminate();
+	DisplayInitialize();
+	}
+Run();
+CHECK(gCounters.errors == 0);
+CHECK(gMAXRegisters[0x04] == 0x01);
+CHECK(gMAXRegisters[0x08] == 0xFF && gMAXRegisters[0x0B] == 0xFF);
+CHECK(DisplayIs(0, "111.111"));
+
+DisplayTerminate();
+Run();
+CHECK(gMAXRegisters[0x04] == 0x00);
+CHECK(gMAXRegisters[0x08] == 0x00 && gMAXRegisters[0x0B] == 0x00);
+
+// odd length: refused
+static char odd[] = { 0x02, 0x07, 0x02 };
+const uint8_t intensity = gMAXRegisters[0x02];
+SPIStartExchange(odd, sizeof odd, NULL);
+Run();
+CHECK(gCounters.errors == 1);
+CHECK(gMAXRegisters[0x02] == intensity);
+gCounters.errors = 0;
+
+CHECK(gMAXFramingErrors == 0);
+
+return Finish();
+}
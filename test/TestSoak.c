@@ -0,0 +1,93 @@
+/*
+	TestSoak
+	
+	Endpoint 1 over thousands of transactions: the data toggles stay in step
+	with the host's, and the buffer descriptors are handed back and forth
+	as they should be
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <xc.h>
+
+#include "Counters.h"
+#include "Display.h"
+#include "Timer1.h"
+#include "USB.h"
+#include "USBEndpoint1.h"
+#include "Harness.h"
+#include "Host.h"
+#include "MAX6954.h"
+
+
+/*	kSoak
+	OUT reports sent; and after every so many, a key press whose two IN
+	reports (the key, then none) the host collects
+*/
+enum {
+	kSoakReports = 5000,
+	kSoakKeyEvery = 10
+	};
+
+
+int main()
+{
+MAXAttach();
+HostAttach();
+Start();
+HostConfigure();
+
+const uint16_t received = gCounters.reportsReceived;
+const uint16_t sent = gCounters.reportsSent;
+unsigned displayed = 0, keys = 0, inArmed = 0;
+
+for (unsigned r = 0; r < kSoakReports; r++) {
+	// a values report, with the next toggle
+	const uint32_t value0 = r, value1 = 999999 - r;
+	const uint64_t values = value0 | (uint64_t) value1 << 20;
+	uint8_t out[kValuesReportLength] = { kReportIDValues };
+	for (uint8_t b = 0; b < kValuesLength; b++)
+		out[1 + b] = (uint8_t) (values >> 8 * b);
+	CHECK(HostOUT1(out, sizeof out) == kHostACK);
+	
+	// handled (a toggle out of step would have been ACKed, and ignored);
+	// and both OUT buffer descriptors armed again
+	if (gValue0 == value0 && gValue1 == value1) displayed++;
+	CHECK(ep1Out[0].STAT.UOWN && ep1Out[1].STAT.UOWN);
+	
+	if (r % kSoakKeyEvery == 0) {
+		const uint32_t key = 1ul << 12;
+		MAXPress(key);
+		MAXRelease(key);
+		Tick(100);
+		
+		// both reports waiting in the IN buffer descriptors
+		if (ep1In[0].STAT.UOWN && ep1In[1].STAT.UOWN) inArmed++;
+		
+		uint8_t in[kInputReportLength], inL;
+		uint32_t collected[2] = { 0xFFFFFFFF, 0xFFFFFFFF };
+		for (uint8_t c = 0; c < 2; c++)
+			if (HostIN1(in, &inL) == kHostACK && inL == kInputReportLength)
+				memcpy(&collected[c], in + kValuesReportLength, sizeof collected[c]);
+		
+		if (collected[0] == key && collected[1] == 0) keys++;
+		
+		// and then nothing more: both IN buffer descriptors back with the firmware
+		CHECK(HostIN1(in, &inL) == kHostNAK);
+		CHECK(!ep1In[0].STAT.UOWN && !ep1In[1].STAT.UOWN);
+		}
+	}
+
+CHECK(displayed == kSoakReports);
+CHECK(keys == kSoakReports / kSoakKeyEvery);
+CHECK(inArmed == kSoakReports / kSoakKeyEvery);
+CHECK((uint16_t) (gCounters.reportsReceived - received) == kSoakReports);
+CHECK((uint16_t) (gCounters.reportsSent - sent) == 2 * kSoakReports / kSoakKeyEvery);
+CHECK(gHostINDropped == 0);
+
+return Finish();
+}
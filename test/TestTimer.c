@@ -0,0 +1,81 @@
+/*
+	TestTimer
+	
+	The 1 ms tick, the software timers, and the tick self-test
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Timer.h"
+#include "Timer2.h"
+#include "Harness.h"
+
+
+static unsigned gFired;
+
+static void Fired() { gFired++; }
+
+
+int main()
+{
+Start();
+
+// ticks
+const uint16_t ticks = gTimer2Ticks;
+Tick(10);
+CHECK((uint16_t) (gTimer2Ticks - ticks) == 10);
+
+// one-shot: fires on the tick the delay ends, and only once
+Timer once = { 0 };
+TimerStart(&once, Fired, 5, 0);
+Tick(4);
+CHECK(gFired == 0);
+Tick(1);
+CHECK(gFired == 1);
+Tick(20);
+CHECK(gFired == 1);
+CHECK(!once.running);
+
+// periodic
+Timer periodic = { 0 };
+gFired = 0;
+TimerStart(&periodic, Fired, 3, 7);
+Tick(3);
+CHECK(gFired == 1);
+Tick(7 * 4);
+CHECK(gFired == 5);
+
+// stopped: doesn't fire again
+TimerStop(&periodic);
+Tick(30);
+CHECK(gFired == 5);
+
+// timers in the same list, in any order of expiry
+Timer a = { 0 }, b = { 0 };
+gFired = 0;
+TimerStart(&a, Fired, 9, 0);
+TimerStart(&b, Fired, 2, 0);
+Tick(2);
+CHECK(gFired == 1);
+Tick(7);
+CHECK(gFired == 2);
+
+// the tick self-test: frames and ticks agree
+Tick(3000);
+CHECK(gTickDrift == 0);
+CHECK(gTickTestFailures == 0);
+
+// ten frames more than ticks in a test period
+Tick(500);
+UFRML += 10;
+Tick(1500);
+CHECK(gTickDrift == 10 || gTickDrift == 0);
+CHECK(gTickTestFailures == 1);
+
+return Finish();
+}
@@ -0,0 +1,52 @@
+/*
+	TestTimestamp
+	
+	The µs into the frame, as the Input reports carry them
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Timer1.h"
+#include "Harness.h"
+
+
+/*	Subframe
+	The subframe of a timestamp taken the given µs after the Start-of-Frame
+*/
+static uint16_t Subframe(
+	uint16_t	after
+	)
+{
+const uint16_t now = (uint16_t) gMicroseconds + after;
+TMR1H = (uint8_t) (now >> 8);
+TMR1L = (uint8_t) now;
+
+Timestamp timestamp;
+GetTimestamp(&timestamp);
+return timestamp.subframe;
+}
+
+
+int main()
+{
+Start();
+Tick(10);
+
+CHECK(Subframe(0) == 0);
+CHECK(Subframe(500) == 500);
+CHECK(Subframe(999) == 999);
+
+// up to 1% over: still the end of this frame
+CHECK(Subframe(1000) == 999);
+CHECK(Subframe(1009) == 999);
+
+// more than that: the Start-of-Frame went missing
+CHECK(Subframe(1010) == 0xFFFF);
+
+return Finish();
+}
@@ -0,0 +1,141 @@
+/*
+	TestTrace
+	
+	The event trace, as the host reads it through the vendor requests (see
+	tools/Timeline.c)
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+*/
+
+#include <stdbool.h>
+
+#include <xc.h>
+
+#include "Counters.h"
+#include "Trace.h"
+#include "USB.h"
+#include "USBEndpoint1.h"
+#include "Harness.h"
+#include "Host.h"
+#include "MAX6954.h"
+
+
+enum {
+	kToDeviceVendorDevice = 0b01000000,
+	kToHostVendorDevice = 0b11000000
+	};
+
+
+/*	gEntries
+	The trace, as read by the host: oldest first
+*/
+static uint8_t gEntries[kTraceLength * sizeof (TraceEntry)];
+static unsigned gEntriesN;
+
+
+/*	ReadTrace
+	Stop the trace, read it, and start it again; as the host does
+*/
+static bool ReadTrace()
+{
+uint8_t status[2];
+if (HostControl(kToHostVendorDevice, kTraceRequestStop, 0, 0, sizeof status, status) != kHostACK) return false;
+
+// the oldest entries first: from the next one, if the buffer has wrapped around
+const unsigned next = status[0];
+unsigned from = status[1] ? next : 0;
+gEntriesN = status[1] ? kTraceLength : next;
+
+for (unsigned n = 0; n < gEntriesN; ) {
+	uint8_t chunk[255];
+	const unsigned entries = kTraceLength - from < 85 ? kTraceLength - from : 85;
+	if (HostControl(kToHostVendorDevice, kTraceRequestRead, from, 0, entries * sizeof (TraceEntry), chunk) != kHostACK) return false;
+	
+	for (unsigned e = 0; e < entries && n < gEntriesN; e++, n++)
+		for (unsigned b = 0; b < sizeof (TraceEntry); b++)
+			gEntries[n * sizeof (TraceEntry) + b] = chunk[e * sizeof (TraceEntry) + b];
+	
+	from = (from + entries) % kTraceLength;
+	}
+
+return HostControl(kToDeviceVendorDevice, kTraceRequestStart, 0, 0, 0, NULL) == kHostACK;
+}
+
+
+/*	Recorded
+	How many entries of the given event the host read
+*/
+static unsigned Recorded(
+	uint8_t		event
+	)
+{
+unsigned n = 0;
+for (unsigned e = 0; e < gEntriesN; e++)
+	if (gEntries[e * sizeof (TraceEntry)] == event) n++;
+return n;
+}
+
+
+/*	Time
+	The µs clock of an entry the host read
+*/
+static uint16_t Time(
+	unsigned	e
+	)
+{
+return gEntries[e * sizeof (TraceEntry) + 1] | gEntries[e * sizeof (TraceEntry) + 2] << 8;
+}
+
+
+int main()
+{
+MAXAttach();
+HostAttach();
+Start();
+HostConfigure();
+
+// start afresh; then a report
+CHECK(ReadTrace());
+const uint8_t report[kValuesReportLength] = { kReportIDValues, 0x40, 0xE2, 0x01, 0x00, 0x00 };
+CHECK(HostOUT1(report, sizeof report) == kHostACK);
+Tick(10);
+
+CHECK(ReadTrace());
+CHECK(Recorded(kTraceOUTReceived) == 1);
+CHECK(Recorded(kTraceSPIStart) > 0);
+CHECK(Recorded(kTraceSPIStart) == Recorded(kTraceSPIDone));
+CHECK(Recorded(kTraceIdle) == 0);
+
+// nothing for 100 ms: an idle entry every 32 ms or so; so that consecutive
+// entries are less than 32.768 ms (and certainly 65.536) apart
+Tick(100);
+CHECK(ReadTrace());
+CHECK(Recorded(kTraceIdle) == 3);
+for (unsigned e = 1; e < gEntriesN; e++)
+	CHECK((uint16_t) (Time(e) - Time(e - 1)) < 0x8000 + 1000);
+
+// a key press
+MAXPress(1);
+Tick(100);
+MAXRelease(1);
+Tick(100);
+CHECK(ReadTrace());
+CHECK(Recorded(kTraceIRQ) > 0);
+CHECK(Recorded(kTraceKeysRead) > 0);
+CHECK(Recorded(kTraceINArmed) > 0);
+
+// around the buffer more than once
+Tick(10000);
+CHECK(ReadTrace());
+CHECK(gEntriesN == kTraceLength);
+CHECK(Recorded(kTraceIdle) == kTraceLength);
+
+// reading past the end of the buffer
+uint8_t entry[sizeof (TraceEntry)];
+CHECK(HostControl(kToHostVendorDevice, kTraceRequestRead, kTraceLength, 0, sizeof entry, entry) == kHostSTALL);
+CHECK(gCounters.errors == 1);
+gCounters.errors = 0;
+
+return Finish();
+}
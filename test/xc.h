@@ -0,0 +1,173 @@
+/*
+	xc
+	
+	PIC18F45K50 register model, standing in for the XC8 <xc.h> when the
+	firmware is compiled on a development machine (see Makefile)
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+ 	References:
+		[PIC] Microchip PIC18(L)F2X/45K50 Data Sheet
+		[XC8] MPLAB XC8 C Compiler User's Guide for PIC MCU
+	
+	The special function registers are plain memory, with the bit layouts of
+	[PIC: Special Function Registers]; the test drives the peripherals by
+	setting flags and calling the interrupt handlers, as the hardware would.
+	
+	A few registers act as the hardware does when they are written; for
+	those, every access goes through a function (see Registers.c) that first
+	catches up with the value the firmware left there the previous time.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+// XC8 extensions [XC8]
+#define __uint24 uint32_t
+#define __int24 int32_t
+#define __at(address)
+#define __interrupt(priority)
+#define high_priority
+#define low_priority
+
+#define SLEEP() ((void) 0)
+#define NOP() ((void) 0)
+
+#define __18F45K50 1
+
+
+/*	Register
+	Special function register storage: declared everywhere, and defined once
+	in Registers.c
+*/
+#if defined(REGISTERS_DEFINE)
+	#define REGISTER(type, name) volatile type name;
+#else
+	#define REGISTER(type, name) extern volatile type name;
+	#endif
+
+#define BIT(name) unsigned name : 1;
+#define SFR(name, fields) \
+	typedef union { uint8_t reg; struct { fields }; } name##bits_t; \
+	REGISTER(name##bits_t, name##bits)
+
+
+typedef union {
+	uint8_t		reg;
+	struct { BIT(IOCIF) BIT(INT0IF) BIT(TMR0IF) BIT(IOCIE) BIT(INT0IE) BIT(TMR0IE) BIT(PEIE) BIT(GIE) };
+	struct { unsigned : 6; BIT(GIEL) BIT(GIEH) };
+	} INTCONbits_t;
+REGISTER(INTCONbits_t, INTCONbits)
+
+SFR(INTCON2, BIT(IOCIP) unsigned : 1; BIT(TMR0IP) unsigned : 1; BIT(INTEDG2) BIT(INTEDG1) BIT(INTEDG0) BIT(RBPU))
+SFR(INTCON3, BIT(INT1IF) BIT(INT2IF) unsigned : 1; BIT(INT1IE) BIT(INT2IE) unsigned : 1; BIT(INT1IP) BIT(INT2IP))
+SFR(RCON, BIT(BOR) BIT(POR) BIT(PD) BIT(TO) BIT(RI) unsigned : 1; BIT(SBOREN) BIT(IPEN))
+/* Timer 2 is only modelled while its interrupt is disabled (i.e., while the
+   firmware polls it during initialization): then every access to PIR1 finds
+   another period elapsed.  After that, the test supplies the ticks. */
+SFR(PIR1_, BIT(TMR1IF) BIT(TMR2IF) BIT(CCP1IF) BIT(SSPIF) BIT(TXIF) BIT(RCIF) BIT(ADIF) unsigned : 1;)
+extern volatile PIR1_bits_t *PIR1Access(void);
+#define PIR1bits (*PIR1Access())
+SFR(PIE1, BIT(TMR1IE) BIT(TMR2IE) BIT(CCP1IE) BIT(SSPIE) BIT(TXIE) BIT(RCIE) BIT(ADIE) unsigned : 1;)
+SFR(IPR1, BIT(TMR1IP) BIT(TMR2IP) BIT(CCP1IP) BIT(SSPIP) BIT(TXIP) BIT(RCIP) BIT(ADIP) unsigned : 1;)
+SFR(PIR3, BIT(TMR1GIF) BIT(TMR3GIF) BIT(USBIF) BIT(CTMUIF) unsigned : 4;)
+SFR(PIE3, BIT(TMR1GIE) BIT(TMR3GIE) BIT(USBIE) BIT(CTMUIE) unsigned : 4;)
+SFR(IPR3, BIT(TMR1GIP) BIT(TMR3GIP) BIT(USBIP) BIT(CTMUIP) unsigned : 4;)
+
+SFR(OSCCON, unsigned SCS : 2; BIT(HFIOFS) BIT(OSTS) unsigned IRCF : 3; BIT(IDLEN))
+SFR(OSCCON2, BIT(LFIOFS) BIT(MFIOFS) BIT(PRISD) BIT(SOSCGO) BIT(PLLEN) unsigned : 1; BIT(SOSCRUN) BIT(PLLRDY))
+SFR(OSCTUNE, unsigned TUN : 6; BIT(SPLLMULT) BIT(INTSRC))
+
+// timers
+SFR(T0CON, unsigned T0PS : 3; BIT(PSA) BIT(T0SE) BIT(T0CS) BIT(T08BIT) BIT(TMR0ON))
+SFR(T1CON, BIT(TMR1ON) BIT(RD16) BIT(T1SYNC) BIT(SOSCEN) unsigned T1CKPS : 2; unsigned TMR1CS : 2;)
+SFR(T2CON, unsigned T2CKPS : 2; BIT(TMR2ON) unsigned T2OUTPS : 4; unsigned : 1;)
+SFR(TMR0H, unsigned : 8;)
+SFR(TMR0L, unsigned : 8;)
+SFR(TMR1H, unsigned : 8;)
+SFR(TMR1L, unsigned : 8;)
+SFR(TMR2, unsigned : 8;)
+SFR(PR2, unsigned : 8;)
+
+#define T1CON T1CONbits.reg
+#define T2CON T2CONbits.reg
+#define TMR0H TMR0Hbits.reg
+#define TMR0L TMR0Lbits.reg
+#define TMR1H TMR1Hbits.reg
+#define TMR1L TMR1Lbits.reg
+#define TMR2 TMR2bits.reg
+#define PR2 PR2bits.reg
+
+// MSSP in SPI master mode
+SFR(SSP1STAT, BIT(BF) BIT(UA) BIT(R_nW) BIT(S) BIT(P) BIT(D_nA) BIT(CKE) BIT(SMP))
+SFR(SSP1CON1, unsigned SSPM : 4; BIT(CKP) BIT(SSPEN) BIT(SSPOV) BIT(WCOL))
+
+#define SSP1STAT SSP1STATbits.reg
+#define SSP1CON1 SSP1CON1bits.reg
+
+/* Sixteen bits wide here: bit 8 marks a byte the SPI model shifted in, which
+   the firmware hasn't replaced by one to shift out yet (see MAX6954.c). */
+REGISTER(uint16_t, SSP1BUF)
+
+// USB
+SFR(UCFG, unsigned PPB : 2; BIT(FSEN) BIT(UTRDIS) BIT(UPUEN) unsigned : 1; BIT(UOEMON) BIT(UTEYE))
+SFR(UIR, BIT(URSTIF) BIT(UERRIF) BIT(ACTVIF) BIT(TRNIF) BIT(IDLEIF) BIT(STALLIF) BIT(SOFIF) unsigned : 1;)
+SFR(UIE, BIT(URSTIE) BIT(UERRIE) BIT(ACTVIE) BIT(TRNIE) BIT(IDLEIE) BIT(STALLIE) BIT(SOFIE) unsigned : 1;)
+SFR(UEIR, BIT(PIDEF) BIT(CRC5EF) BIT(CRC16EF) BIT(DFN8EF) BIT(BTOEF) unsigned : 2; BIT(BTSEF))
+SFR(UEIE, BIT(PIDEE) BIT(CRC5EE) BIT(CRC16EE) BIT(DFN8EE) BIT(BTOEE) unsigned : 2; BIT(BTSEE))
+SFR(USTAT, unsigned : 1; BIT(PPBI) BIT(DIR) unsigned ENDP : 4; unsigned : 1;)
+SFR(UADDR, unsigned ADDR : 7; unsigned : 1;)
+SFR(UFRML, unsigned : 8;)
+SFR(UFRMH, unsigned FRM : 3; unsigned : 5;)
+SFR(UEP0, BIT(EPSTALL) BIT(EPINEN) BIT(EPOUTEN) BIT(EPCONDIS) BIT(EPHSHK) unsigned : 3;)
+SFR(UEP1, BIT(EPSTALL) BIT(EPINEN) BIT(EPOUTEN) BIT(EPCONDIS) BIT(EPHSHK) unsigned : 3;)
+
+#define UEIR UEIRbits.reg
+#define UEIE UEIEbits.reg
+#define UADDR UADDRbits.reg
+#define UFRML UFRMLbits.reg
+#define UFRMH UFRMHbits.reg
+#define UEP0 UEP0bits.reg
+#define UEP1 UEP1bits.reg
+
+/* UCON.PPBRST resets the SIE's ping-pong buffer pointers while it is set
+   [PIC: USB Control Register]; the firmware sets and clears it again
+   straight away. */
+SFR(UCON_, unsigned : 1; BIT(SUSPND) BIT(RESUME) BIT(USBEN) BIT(PKTDIS) BIT(SE0) BIT(PPBRST) unsigned : 1;)
+extern volatile UCON_bits_t *UCONAccess(void);
+#define UCONbits (*UCONAccess())
+#define UCON UCONbits.reg
+
+// ports
+#define PORT(p) \
+	SFR(PORT##p, BIT(R##p##0) BIT(R##p##1) BIT(R##p##2) BIT(R##p##3) BIT(R##p##4) BIT(R##p##5) BIT(R##p##6) BIT(R##p##7)) \
+	typedef union { \
+		uint8_t reg; \
+		struct { BIT(R##p##0) BIT(R##p##1) BIT(R##p##2) BIT(R##p##3) BIT(R##p##4) BIT(R##p##5) BIT(R##p##6) BIT(R##p##7) }; \
+		struct { BIT(TRIS##p##0) BIT(TRIS##p##1) BIT(TRIS##p##2) BIT(TRIS##p##3) BIT(TRIS##p##4) BIT(TRIS##p##5) BIT(TRIS##p##6) BIT(TRIS##p##7) }; \
+		} TRIS##p##bits_t; \
+	REGISTER(TRIS##p##bits_t, TRIS##p##bits) \
+	SFR(ANSEL##p, BIT(ANS##p##0) BIT(ANS##p##1) BIT(ANS##p##2) BIT(ANS##p##3) BIT(ANS##p##4) BIT(ANS##p##5) BIT(ANS##p##6) BIT(ANS##p##7))
+
+#define LATCH(p) \
+	SFR(LAT##p, BIT(LAT##p##0) BIT(LAT##p##1) BIT(LAT##p##2) BIT(LAT##p##3) BIT(LAT##p##4) BIT(LAT##p##5) BIT(LAT##p##6) BIT(LAT##p##7))
+
+PORT(A) PORT(B) PORT(C) PORT(D)
+LATCH(B) LATCH(C) LATCH(D)
+
+#define LATD LATDbits.reg
+
+/* LATA5 is the MAX6954 chip select; the SPI model latches a command when it
+   goes high. */
+SFR(LATA_, BIT(LATA0) BIT(LATA1) BIT(LATA2) BIT(LATA3) BIT(LATA4) BIT(LATA5) BIT(LATA6) BIT(LATA7))
+extern volatile LATA_bits_t *LATAAccess(void);
+#define LATAbits (*LATAAccess())
+
+SFR(WPUB, BIT(WPUB0) BIT(WPUB1) BIT(WPUB2) BIT(WPUB3) BIT(WPUB4) BIT(WPUB5) BIT(WPUB6) BIT(WPUB7))
+SFR(IOCB, unsigned : 4; BIT(IOCB4) BIT(IOCB5) BIT(IOCB6) BIT(IOCB7))
+
+#define WPUB WPUBbits.reg
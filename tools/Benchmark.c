@@ -0,0 +1,307 @@
+/*
+	Benchmark
+	
+	Time the firmware's hot paths under a fixed workload, and fail when they
+	have become slower than a baseline
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+ 	References:
+		[HID] Device Class Definition for Human Interface Devices (HID) Version 1.11
+	
+	For a panel running a PROFILE build (see Profile.h), through its Linux
+	hidraw device:
+	
+		Benchmark [-w baseline | -b baseline [-t percent]] /dev/hidrawN
+	
+	Resets the statistics; sends the workload; then reads the statistics
+	back, and prints the minimum, average and maximum instruction cycles of
+	each path, and of each interrupt latency measured.  With -w, also records the averages and maxima as the
+	baseline (from a build known to be good).  With -b, exits with status 1
+	if any path's average or maximum exceeds the baseline's by more than the
+	threshold (10% unless given with -t).
+	
+	The maxima include whatever interrupts arrived during a main-line path
+	(see ProfileRecord); the threshold has to allow for that.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/ioctl.h>
+#include <linux/hidraw.h>
+
+
+/*	kReportID
+	As in USBEndpoint1.h
+*/
+enum {
+	kReportIDValues = 1,
+	kReportIDProfile = 4
+	};
+
+
+/*	gPaths
+	The paths, in the order of ProfilePath (see Profile.h)
+*/
+static const char *const gPaths[] = {
+	"USBInterrupt",
+	"SPIInterrupt",
+	"DisplayValues",
+	"Endpoint0SETUP",
+	"SPILatency",
+	"TickLatency"
+	};
+
+enum { kPathsN = sizeof gPaths / sizeof gPaths[0] };
+
+
+/*	kProfileReportLength
+	Report ID, and a ProfileStats per path: uint16_t min, max; uint32_t total;
+	uint16_t count; little-endian, not padded
+*/
+enum {
+	kStatsLength = 10,
+	kProfileReportLength = 1 + kPathsN * kStatsLength
+	};
+
+
+/*	kWorkload
+	The workload: Output reports of values that change every digit, at the
+	default polling interval; and every tenth, the host reading the values
+	back through the control pipe (a Feature report)
+*/
+enum {
+	kWorkloadReports = 1000,
+	kWorkloadInterval = 10 /* ms */,
+	kWorkloadReadEvery = 10
+	};
+
+
+/*	Stats
+	One path's statistics, as read from the panel
+*/
+typedef struct {
+	unsigned	min, max, count;
+	double		average;
+	} Stats;
+
+
+/*	Little16, Little32
+	Unpack little-endian
+*/
+static unsigned Little16(
+	const uint8_t	*b
+	)
+{
+return b[0] | b[1] << 8;
+}
+
+static unsigned long Little32(
+	const uint8_t	*b
+	)
+{
+return b[0] | b[1] << 8 | (unsigned long) b[2] << 16 | (unsigned long) b[3] << 24;
+}
+
+
+/*	Fail
+	Report the error, with errno, and exit
+*/
+static void Fail(
+	const char	*what
+	)
+{
+fprintf(stderr, "Benchmark: %s: %s\n", what, strerror(errno));
+exit(2);
+}
+
+
+/*	Sleep
+	Wait the given ms
+*/
+static void Sleep(
+	unsigned	ms
+	)
+{
+const struct timespec t = { ms / 1000, ms % 1000 * 1000000L };
+nanosleep(&t, NULL);
+}
+
+
+/*	SendValues
+	Send an Output report with the two 20-bit values (packed as in
+	PackValues)
+*/
+static void SendValues(
+	int		device,
+	uint32_t	v0,
+	uint32_t	v1
+	)
+{
+const uint64_t packed = v0 | (uint64_t) v1 << 20;
+uint8_t report[6] = { kReportIDValues };
+for (int i = 0; i < 5; i++)
+	report[1 + i] = (uint8_t) (packed >> 8 * i);
+
+if (write(device, report, sizeof report) != sizeof report) Fail("write");
+}
+
+
+/*	RunWorkload
+	Reset the statistics, and run the workload
+*/
+static void RunWorkload(
+	int		device
+	)
+{
+// reset: the report ID alone
+uint8_t reset[1] = { kReportIDProfile };
+if (ioctl(device, HIDIOCSFEATURE(sizeof reset), reset) < 0) Fail("reset");
+
+for (unsigned r = 0; r < kWorkloadReports; r++) {
+	// every digit different from the previous report's
+	const uint32_t v = r % 10 * 111111;
+	SendValues(device, v, 999999 - v);
+	
+	if (r % kWorkloadReadEvery == 0) {
+		uint8_t values[6] = { kReportIDValues };
+		if (ioctl(device, HIDIOCGFEATURE(sizeof values), values) < 0) Fail("read values");
+		}
+	
+	Sleep(kWorkloadInterval);
+	}
+}
+
+
+/*	ReadStats
+	Read the statistics of each path
+*/
+static void ReadStats(
+	int		device,
+	Stats		*stats
+	)
+{
+uint8_t report[kProfileReportLength] = { kReportIDProfile };
+if (ioctl(device, HIDIOCGFEATURE(sizeof report), report) < kProfileReportLength) Fail("read statistics");
+
+for (int p = 0; p < kPathsN; p++) {
+	const uint8_t *b = report + 1 + p * kStatsLength;
+	stats[p].min = Little16(b);
+	stats[p].max = Little16(b + 2);
+	stats[p].count = Little16(b + 8);
+	stats[p].average = stats[p].count ? (double) Little32(b + 4) / stats[p].count : 0;
+	}
+}
+
+
+/*	Compare
+	Whether the statistics are within the threshold of the baseline; notes
+	each path that isn't
+*/
+static bool Compare(
+	const Stats	*stats,
+	const char	*baselinePath,
+	unsigned	threshold
+	)
+{
+FILE *const baseline = fopen(baselinePath, "r");
+if (!baseline) Fail(baselinePath);
+
+bool pass = true;
+char path[32];
+double average;
+unsigned max;
+while (fscanf(baseline, "%31s %lf %u", path, &average, &max) == 3) {
+	int p = 0;
+	while (p < kPathsN && strcmp(path, gPaths[p]) != 0) p++;
+	if (p == kPathsN) {
+		fprintf(stderr, "Benchmark: %s: unknown path %s\n", baselinePath, path);
+		exit(2);
+		}
+	
+	const double limit = (100.0 + threshold) / 100.0;
+	if (stats[p].count == 0) {
+		printf("FAIL %s: not reached by the workload\n", path);
+		pass = false;
+		}
+	
+	else if (stats[p].average > average * limit || stats[p].max > max * limit) {
+		printf("FAIL %s: average %.1f, maximum %u; baseline %.1f, %u (+%u%%)\n",
+			path, stats[p].average, stats[p].max, average, max, threshold);
+		pass = false;
+		}
+	}
+
+fclose(baseline);
+return pass;
+}
+
+
+/*	Record
+	Write the statistics as the baseline
+*/
+static void Record(
+	const Stats	*stats,
+	const char	*baselinePath
+	)
+{
+FILE *const baseline = fopen(baselinePath, "w");
+if (!baseline) Fail(baselinePath);
+
+for (int p = 0; p < kPathsN; p++)
+	if (stats[p].count)
+		fprintf(baseline, "%s %.1f %u\n", gPaths[p], stats[p].average, stats[p].max);
+
+if (fclose(baseline) != 0) Fail(baselinePath);
+}
+
+
+int main(
+	int		argc,
+	char		**argv
+	)
+{
+const char *record = NULL, *compare = NULL;
+unsigned threshold = 10;
+
+int option;
+while ((option = getopt(argc, argv, "w:b:t:")) != -1)
+	switch (option) {
+		case 'w': record = optarg; break;
+		case 'b': compare = optarg; break;
+		case 't': threshold = (unsigned) atoi(optarg); break;
+		default: optind = argc + 1;
+		}
+
+if (optind != argc - 1 || (record && compare)) {
+	fprintf(stderr, "usage: Benchmark [-w baseline | -b baseline [-t percent]] /dev/hidrawN\n");
+	return 2;
+	}
+
+const int device = open(argv[optind], O_RDWR);
+if (device < 0) Fail(argv[optind]);
+
+RunWorkload(device);
+
+Stats stats[kPathsN];
+ReadStats(device, stats);
+close(device);
+
+printf("%-16s %8s %8s %8s %8s\n", "path", "calls", "min", "avg", "max");
+for (int p = 0; p < kPathsN; p++)
+	printf("%-16s %8u %8u %8.1f %8u\n", gPaths[p], stats[p].count,
+		stats[p].count ? stats[p].min : 0, stats[p].average, stats[p].max);
+
+if (record) Record(stats, record);
+
+return compare && !Compare(stats, compare, threshold) ? 1 : 0;
+}
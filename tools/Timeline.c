@@ -0,0 +1,275 @@
+/*
+	Timeline
+	
+	Read the event trace from a panel, and render it as a timeline
+	Microchip PIC18 USB Radio Panel firmware
+	
+	2026/10/16	Originated
+	
+ 	References:
+		[USB] Universal Serial Bus Specification, Revision 2.0
+	
+	For a panel running a TRACE build (see Trace.h), through its Linux usbfs
+	device:
+	
+		Timeline [-o dump] /dev/bus/usb/BBB/DDD
+		Timeline -f dump
+	
+	Stops the trace; reads the entries, oldest first; and starts it again
+	(see kTraceRequest).  With -o, also saves them, as read, to render again
+	later with -f.
+	
+	Each entry is rendered on a line of its own: the ms since the oldest
+	entry, the µs since the previous one, and the event in the column of
+	what it happened to (USB, SPI, keys).  The clock wraps around every
+	65.536 ms; the firmware records an idle entry at least every 32.768 ms,
+	so that the differences taken modulo 65536 are unambiguous.  Idle entries
+	themselves are only counted, on the next line.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/ioctl.h>
+#include <linux/usbdevice_fs.h>
+
+
+/*	kTraceRequest
+	As in Trace.h
+*/
+enum {
+	kTraceRequestStop = 1,
+	kTraceRequestRead,
+	kTraceRequestStart
+	};
+
+
+/*	kTraceEvent
+	As in Trace.h
+*/
+enum {
+	kTraceIdle = 1,
+	kTraceOUTReceived,
+	kTraceINArmed,
+	kTraceINSent,
+	kTraceSPIStart,
+	kTraceSPIDone,
+	kTraceIRQ,
+	kTraceKeysRead,
+	kTraceKeysReadIRQLow
+	};
+
+
+/*	kTrace
+	Entries in the ring buffer; 3 bytes each (event, and µs clock
+	little-endian); at most 85 per read request
+*/
+enum {
+	kTraceLength = 256,
+	kEntryLength = 3,
+	kReadEntries = 255 / kEntryLength
+	};
+
+
+/*	kColumn
+	Where on the line each kind of event goes
+*/
+enum {
+	kColumnUSB,
+	kColumnSPI,
+	kColumnKeys,
+	kColumnN
+	};
+
+static const struct {
+	uint8_t		column;
+	const char	*name;
+	} gEvents[] = {
+	[kTraceOUTReceived] =		{ kColumnUSB, "OUT received" },
+	[kTraceINArmed] =		{ kColumnUSB, "IN armed" },
+	[kTraceINSent] =		{ kColumnUSB, "IN sent" },
+	[kTraceSPIStart] =		{ kColumnSPI, "start" },
+	[kTraceSPIDone] =		{ kColumnSPI, "done" },
+	[kTraceIRQ] =			{ kColumnKeys, "IRQ" },
+	[kTraceKeysRead] =		{ kColumnKeys, "read" },
+	[kTraceKeysReadIRQLow] =	{ kColumnKeys, "read, IRQ low" }
+	};
+
+enum { kColumnWidth = 16 };
+
+
+/*	Fail
+	Report the error, with errno, and exit
+*/
+static void Fail(
+	const char	*what
+	)
+{
+fprintf(stderr, "Timeline: %s: %s\n", what, strerror(errno));
+exit(2);
+}
+
+
+/*	Control
+	A vendor request to the device [USB §9.3]; gives the bytes transferred
+*/
+static int Control(
+	int		device,
+	uint8_t		bmRequestType,
+	uint8_t		bRequest,
+	uint16_t	wValue,
+	uint16_t	wLength,
+	uint8_t		*data
+	)
+{
+struct usbdevfs_ctrltransfer transfer = {
+	.bRequestType = bmRequestType,
+	.bRequest = bRequest,
+	.wValue = wValue,
+	.wIndex = 0,
+	.wLength = wLength,
+	.timeout = 1000 /* ms */,
+	.data = data
+	};
+
+const int transferred = ioctl(device, USBDEVFS_CONTROL, &transfer);
+if (transferred < 0) Fail("control request");
+return transferred;
+}
+
+
+/*	ReadTrace
+	Read the entries from the panel, oldest first; gives how many
+*/
+static unsigned ReadTrace(
+	const char	*path,
+	uint8_t		*entries
+	)
+{
+const int device = open(path, O_RDWR);
+if (device < 0) Fail(path);
+
+// stop: the index of the next entry, and whether the buffer has wrapped around
+uint8_t status[2];
+if (Control(device, 0b11000000, kTraceRequestStop, 0, sizeof status, status) != sizeof status) {
+	fprintf(stderr, "Timeline: %s: no trace (not a TRACE build?)\n", path);
+	exit(2);
+	}
+
+// the oldest entries first: from the next one, if the buffer has wrapped around
+const unsigned entriesN = status[1] ? kTraceLength : status[0];
+unsigned from = status[1] ? status[0] : 0;
+
+for (unsigned n = 0; n < entriesN; ) {
+	// up to the end of the buffer, or the newest entry
+	unsigned read = kTraceLength - from;
+	if (read > kReadEntries) read = kReadEntries;
+	if (read > entriesN - n) read = entriesN - n;
+	
+	if (Control(device, 0b11000000, kTraceRequestRead, from, read * kEntryLength, entries + n * kEntryLength) != (int) (read * kEntryLength)) {
+		fprintf(stderr, "Timeline: %s: short read\n", path);
+		exit(2);
+		}
+	
+	n += read;
+	from = (from + read) % kTraceLength;
+	}
+
+// start recording again
+Control(device, 0b01000000, kTraceRequestStart, 0, 0, NULL);
+
+close(device);
+return entriesN;
+}
+
+
+/*	Render
+	Print the entries as a timeline
+*/
+static void Render(
+	const uint8_t	*entries,
+	unsigned	entriesN
+	)
+{
+printf("%10s %9s  %-*s%-*s%s\n", "ms", "+us", kColumnWidth, "USB", kColumnWidth, "SPI", "keys");
+
+unsigned long elapsed = 0;
+unsigned idle = 0;
+uint16_t previous = 0;
+
+for (unsigned e = 0; e < entriesN; e++) {
+	const uint8_t *const entry = entries + e * kEntryLength;
+	const uint8_t event = entry[0];
+	const uint16_t time = entry[1] | entry[2] << 8;
+	
+	// consecutive entries are less than 65.536 ms apart
+	const uint16_t delta = e ? (uint16_t) (time - previous) : 0;
+	elapsed += delta;
+	previous = time;
+	
+	if (event == kTraceIdle) { idle++; continue; }
+	
+	if (idle) {
+		printf("%10s %9s  (idle, %u)\n", "", "", idle);
+		idle = 0;
+		}
+	
+	printf("%10.3f %9u  ", elapsed / 1000.0, delta);
+	if (event < sizeof gEvents / sizeof gEvents[0] && gEvents[event].name)
+		printf("%*s%s\n", gEvents[event].column * kColumnWidth, "", gEvents[event].name);
+	else
+		printf("(event %u)\n", event);
+	}
+
+if (idle) printf("%10.3f %9s  (idle, %u)\n", elapsed / 1000.0, "", idle);
+}
+
+
+int main(
+	int		argc,
+	char		**argv
+	)
+{
+const char *save = NULL, *load = NULL;
+
+int option;
+while ((option = getopt(argc, argv, "o:f:")) != -1)
+	switch (option) {
+		case 'o': save = optarg; break;
+		case 'f': load = optarg; break;
+		default: optind = argc + 1;
+		}
+
+if (load ? optind != argc || save : optind != argc - 1) {
+	fprintf(stderr, "usage: Timeline [-o dump] /dev/bus/usb/BBB/DDD\n       Timeline -f dump\n");
+	return 2;
+	}
+
+static uint8_t entries[kTraceLength * kEntryLength];
+unsigned entriesN;
+
+if (load) {
+	FILE *const dump = fopen(load, "rb");
+	if (!dump) Fail(load);
+	entriesN = fread(entries, kEntryLength, kTraceLength, dump);
+	fclose(dump);
+	}
+
+else {
+	entriesN = ReadTrace(argv[optind], entries);
+	
+	if (save) {
+		FILE *const dump = fopen(save, "wb");
+		if (!dump) Fail(save);
+		if (fwrite(entries, kEntryLength, entriesN, dump) != entriesN || fclose(dump) != 0) Fail(save);
+		}
+	}
+
+Render(entries, entriesN);
+return 0;
+}